@@ -5,131 +5,353 @@
 #include <exception>
 #include <limits>
 #include "utils.hpp"
-#include <iostream>
+#include "vector.hpp"
+#include "instrumentation.hpp"
 #include <stdexcept>
 
-#define BST_COMMENTS 0
+// keep a subtree size in every node for rank/select and O(height) distance;
+// build with -D BST_ORDER_STATISTICS=0 to drop the counter and fall back to walks
+#ifndef BST_ORDER_STATISTICS
+	#define BST_ORDER_STATISTICS 1
+#endif
+
+// lookups find_batch keeps in flight at once
+#ifndef BST_BATCH_GROUP
+	#define BST_BATCH_GROUP 16
+#endif
 
 namespace ft
 {
 
+	template<typename value_type>
+	struct nodeStruct;
+
+	// the links of a node; a tree's header is nothing more, so it costs no
+	// value_type. Children are real nodes or NULL; a parent can be the
+	// header, which is why it is only a nodeLinks
+	template<typename value_type>
+	struct nodeLinks
+	{
+		nodeLinks*					parent;
+		nodeStruct<value_type>*		left;
+		nodeStruct<value_type>*		right;
+#if BST_ORDER_STATISTICS
+		size_t						subtreeSize;
+#endif
+
+		nodeLinks()
+			:parent(NULL), left(NULL), right(NULL)
+#if BST_ORDER_STATISTICS
+			, subtreeSize(0)
+#endif
+		{}
+	};
+
 	template<typename value_type>
 	struct nodeStruct
+		: nodeLinks<value_type>
 	{
 		value_type		data;
-		nodeStruct*		parent;
-		nodeStruct*		left;
-		nodeStruct*		right;
 
 		nodeStruct() 
-			:parent(NULL), left(NULL), right(NULL) {}
+		{
+#if BST_ORDER_STATISTICS
+			this->subtreeSize = 1;
+#endif
+		}
 		
 		nodeStruct (value_type val) 
-			:data(val), parent(NULL), left(NULL), right(NULL) {}
+			:data(val)
+		{
+#if BST_ORDER_STATISTICS
+			this->subtreeSize = 1;
+#endif
+		}
 		
 		~nodeStruct() {}
 	};
 
+	// the node behind links that are not a header, to read its data
+	template<typename value_type>
+	inline nodeStruct<value_type>* nodeOf(nodeLinks<value_type>* links)
+	{
+		return static_cast<nodeStruct<value_type>*>(links);
+	}
+
+	template<typename value_type>
+	inline const nodeStruct<value_type>* nodeOf(const nodeLinks<value_type>* links)
+	{
+		return static_cast<const nodeStruct<value_type>*>(links);
+	}
+
+
+// **************************** TREE STATS *****************************
+
+	// shape and memory of a tree, as returned by map::stats(). Depths count
+	// from 0 at the root; a tree of n nodes is as shallow as it can be
+	// when its height equals balanced_height
+	struct map_stats
+	{
+		size_t				node_count;
+		size_t				height;					// levels, 0 when empty
+		size_t				max_depth;
+		double				average_depth;
+		ft::vector<size_t>	depth_histogram;		// nodes at each depth
+		size_t				balanced_height;		// ceil(log2(n + 1))
+		size_t				node_bytes;				// node_count nodes
+		size_t				sentinel_bytes;			// 0: the header lives inside the map
+		size_t				bytes_used;				// nodes; they have no slack
+		// nodes a successful find compares its key with, averaged over
+		// every key of the tree: average_depth + 1
+		double				average_comparisons;
+
+		map_stats()
+			: node_count(0), height(0), max_depth(0), average_depth(0), balanced_height(0),
+			node_bytes(0), sentinel_bytes(0), bytes_used(0), average_comparisons(0) { }
+	};
+
+// *************************** NODE HANDLE ****************************
+
+	// owning handle to a node taken out of a tree (the C++17 node_type): the
+	// node is relinked on insert instead of being copied and reallocated.
+	// C++98 has no move semantics, so copying a handle hands the node over
+	// like std::auto_ptr and leaves the source empty
+	template<typename value_type, typename Allocator>
+	class nodeHandle
+	{
+	public:
+		typedef typename ft::remove_const<typename value_type::first_type>::type	key_type;
+		typedef typename value_type::second_type									mapped_type;
+		typedef Allocator															allocator_type;
+		typedef nodeStruct<value_type>												node;
+
+		nodeHandle()
+			: nodePtr(NULL), allocator() { }
+
+		nodeHandle(node* extracted, const allocator_type& alloc)
+			: nodePtr(extracted), allocator(alloc) { }
+
+		nodeHandle(const nodeHandle& other)
+			: nodePtr(other.release()), allocator(other.allocator) { }
+
+		nodeHandle& operator=(const nodeHandle& rhs)
+		{
+			if (this != &rhs)
+			{
+				reset();
+				allocator = rhs.allocator;
+				nodePtr = rhs.release();
+			}
+			return *this;
+		}
+
+		~nodeHandle()
+		{
+			reset();
+		}
+
+		bool empty() const
+		{
+			return nodePtr == NULL;
+		}
+
+		// the key stays const: it is stored as pair<const Key, T>
+		const key_type& key() const
+		{
+			return nodePtr->data.first;
+		}
+
+		mapped_type& mapped() const
+		{
+			return nodePtr->data.second;
+		}
+
+		allocator_type get_allocator() const
+		{
+			return allocator;
+		}
+
+		void swap(nodeHandle& other)
+		{
+			std::swap(nodePtr, other.nodePtr);
+			std::swap(allocator, other.allocator);
+		}
+
+		node* get() const
+		{
+			return nodePtr;
+		}
+
+		// gives up ownership without freeing the node
+		node* release() const
+		{
+			node* released = nodePtr;
+			nodePtr = NULL;
+			return released;
+		}
+
+	private:
+		void reset()
+		{
+			if (nodePtr == NULL)
+				return;
+			allocator.destroy(nodePtr);
+			allocator.deallocate(nodePtr, 1);
+			nodePtr = NULL;
+		}
+
+		mutable node*	nodePtr;
+		allocator_type	allocator;
+	};
 
 // ******************** NAVIGATION HELPER FUNCTIONS *******************
 
-		template<typename nodePtr>
-		nodePtr nilNode(nodePtr node)
+		// the header of the tree holding links: the only links without parent
+		template<typename linkPtr>
+		linkPtr headerOf(linkPtr links)
 		{
-			while (node->parent != NULL)
-				node = node->parent;
-			return node;
+			while (links->parent != NULL)
+				links = links->parent;
+			return links;
 		}
 
 		template<typename nodePtr>
 		nodePtr min(nodePtr node)
 		{
-			if (node != nilNode(node))
-			{
-				while (node->left != nilNode(node))
-					node = node->left;
-			}
+			while (node->left != NULL)
+				node = node->left;
 			return node;
 		}
 
 		template<typename nodePtr>
 		nodePtr max(nodePtr node)
 		{
-			if (node != nilNode(node))
+			while (node->right != NULL)
+				node = node->right;
+			return node;
+		}
+
+		// the header goes to the last node, the first node to the header
+		template<typename linkPtr>
+		linkPtr predecessor(linkPtr node)
+		{
+			if (node->parent == NULL)
+				return (node->right != NULL ? node->right : node);
+			if (node->left != NULL)
+				return max(node->left);
+			linkPtr predecessorNode = node->parent;
+			while (predecessorNode->parent != NULL && node == predecessorNode->left)
 			{
-				while (node->right != nilNode(node))
-					node = node->right;
+				node = predecessorNode;
+				predecessorNode = predecessorNode->parent;
 			}
-			return node;
+			return predecessorNode;
 		}
 
-		template<typename nodePtr>
-		nodePtr rootNode(nodePtr node)
+		// the last node goes to the header, the header to the first node
+		template<typename linkPtr>
+		linkPtr successor(linkPtr node)
 		{
 			if (node->parent == NULL)
-			{	
-				if (node->left != NULL)
-					node = node->left;
-				else if (node->right != NULL)
-					node = node->right;
+				return (node->left != NULL ? node->left : node);
+			if (node->right != NULL)
+				return min(node->right);
+			linkPtr successorNode = node->parent;
+			while (successorNode->parent != NULL && node == successorNode->right)
+			{
+				node = successorNode;
+				successorNode = successorNode->parent;
 			}
-			while (node->parent != nilNode(node))
-				node = node->parent;
-			return node;
+			return successorNode;
 		}
 
-		template<typename nodePtr>
-		nodePtr predecessor(nodePtr node)
-		{
-			nodePtr rootPtr = rootNode(node);
-			nodePtr nilPtr = nilNode(node);
-			if (node == nilPtr)
-				return max(rootPtr);
-			else if (node == min(rootPtr))
-				return nilPtr;
-			else if (node->left != nilPtr)
-				return max(node->left);
-			else
+
+// ******************** ORDER STATISTIC HELPER FUNCTIONS *******************
+
+		// an empty subtree is NULL
+		template<typename linkPtr>
+		size_t subtreeSize(linkPtr node)
+		{
+			if (node == NULL)
+				return 0;
+#if BST_ORDER_STATISTICS
+			return node->subtreeSize;
+#else
+			return 1 + subtreeSize(node->left) + subtreeSize(node->right);
+#endif
+		}
+
+		// the root of the tree holding links, NULL when it is empty
+		template<typename linkPtr>
+		linkPtr treeRoot(linkPtr links)
+		{
+			if (links->parent == NULL)
 			{
-				nodePtr predecessorNode = node->parent;
-				while (predecessorNode != nilPtr && node == predecessorNode->left)
-				{
-					node = predecessorNode;
-					predecessorNode = predecessorNode->parent;
-				}
-				return predecessorNode;
+				if (links->left == NULL)
+					return NULL;
+				links = links->left;
 			}
+			while (links->parent->parent != NULL)
+				links = links->parent;
+			return links;
 		}
 
-		template<typename nodePtr>
-		nodePtr successor(nodePtr node)
-		{
-			nodePtr root = rootNode(node);
-			nodePtr nil = nilNode(node);
-			if (!node)
-				return (min(root));
-			else if (node == nil)
-				return min(root);
-			else if (node == max(root))
-				return nil;
-			else if (node->right != nil)
-				return min(node->right);
-			else
+		// in-order position of node, the header sits one past the last node
+		template<typename linkPtr>
+		size_t nodeIndex(linkPtr node)
+		{
+			if (node->parent == NULL)
+				return subtreeSize(treeRoot(node));
+#if BST_ORDER_STATISTICS
+			size_t idx = subtreeSize(node->left);
+			while (node->parent->parent != NULL)
 			{
-				nodePtr successorNode = node->parent;
-				while (successorNode != nil && node == successorNode->right)
+				if (node == node->parent->right)
+					idx += subtreeSize(node->parent->left) + 1;
+				node = node->parent;
+			}
+			return idx;
+#else
+			size_t idx = 0;
+			for (linkPtr it = min(treeRoot(node)); it != node; it = successor(it))
+				++idx;
+			return idx;
+#endif
+		}
+
+		// idx-th node in order below root, end when idx is out of range
+		template<typename linkPtr>
+		linkPtr selectNode(linkPtr root, linkPtr end, size_t idx)
+		{
+#if BST_ORDER_STATISTICS
+			linkPtr node = root;
+			while (node != NULL)
+			{
+				size_t leftSize = subtreeSize(node->left);
+				if (idx < leftSize)
+					node = node->left;
+				else if (idx == leftSize)
+					return node;
+				else
 				{
-					node = successorNode;
-					successorNode = successorNode->parent;
+					idx -= leftSize + 1;
+					node = node->right;
 				}
-				return successorNode;
 			}
+			return end;
+#else
+			if (root == NULL)
+				return end;
+			linkPtr node = min(root);
+			for (; idx > 0 && node != end; --idx)
+				node = successor(node);
+			return node;
+#endif
 		}
 
-	
-
 //***********************  ITERATOR *********************
 
+	// holds links: end() is the header, which is not a node
 	template<typename nP, typename v_t>
 	struct bstIterator
 	{
@@ -153,8 +375,6 @@ namespace ft
 		bstIterator(const bstIterator<Iter, val_type>& iter) throw()
 			: bstNode(iter.base())
 		{
-			if (ITERATOR_COMMENTS)
-				std::cout << "bstIterator parameter constructor (to const) called" << std::endl;
 		}
 
 		const nodePointer base() const throw()
@@ -164,32 +384,34 @@ namespace ft
 
 		reference operator*() throw()
 		{
-			return this->bstNode->data;
+			return nodeOf(this->bstNode)->data;
 		}
 
 		constReference operator*() const throw()
 		{
-			return this->bstNode->data;
+			return nodeOf(this->bstNode)->data;
 		}
 
 		pointer operator->() throw()
 		{
-			return &(this->bstNode->data);
+			return &(nodeOf(this->bstNode)->data);
 		}
 
 		pointer operator->() const throw()
 		{
-			return &(this->bstNode->data);
+			return &(nodeOf(this->bstNode)->data);
 		}
 
 		bstIt& operator++() throw()
 		{
+			instrumentation::record(events::TREE, events::ITERATOR_STEPS);
 			this->bstNode = successor(bstNode);
 			return *this;
 		}
 
 		bstIt operator++(int) throw()
 		{
+			instrumentation::record(events::TREE, events::ITERATOR_STEPS);
 			bstIt temp = *this;
 			this->bstNode = successor(bstNode);
 			return temp;
@@ -197,17 +419,46 @@ namespace ft
 
 		bstIt& operator--() throw()
 		{
+			instrumentation::record(events::TREE, events::ITERATOR_STEPS);
 			bstNode = predecessor(bstNode);
 			return *this;
 		}
 
 		bstIt operator--(int) throw()
 		{
+			instrumentation::record(events::TREE, events::ITERATOR_STEPS);
 			bstIt temp = *this;
 			bstNode = predecessor(bstNode);
 			return temp;
 		}
 
+		// O(height) jumps through the subtree sizes, past the ends gives end()
+		bstIt operator+(difference_type n) const throw()
+		{
+			difference_type idx = static_cast<difference_type>(nodeIndex(bstNode)) + n;
+			nodePointer end = headerOf(bstNode);
+			if (idx < 0)
+				return bstIt(end);
+			return bstIt(selectNode(treeRoot(bstNode), end, idx));
+		}
+
+		bstIt operator-(difference_type n) const throw()
+		{
+			return *this + (-n);
+		}
+
+		bstIt& operator+=(difference_type n) throw()
+		{
+			*this = *this + n;
+			return *this;
+		}
+
+		bstIt& operator-=(difference_type n) throw()
+		{
+			*this = *this + (-n);
+			return *this;
+		}
+
 		bool operator==(const bstIt& rhs) const throw()
 		{
 			return bstNode == rhs.bstNode;
@@ -221,9 +472,26 @@ namespace ft
 		nodePointer bstNode;
 	};
 
+	// found through ADL by ft::distance: O(height) instead of one successor() per step
+	template<typename nP, typename v_t>
+	inline ptrdiff_t iteratorDistance(bstIterator<nP, v_t> first, bstIterator<nP, v_t> last, std::bidirectional_iterator_tag)
+	{
+		return static_cast<ptrdiff_t>(nodeIndex(last.bstNode)) - static_cast<ptrdiff_t>(nodeIndex(first.bstNode));
+	}
+
 
+	// The header (end(), the parent of the root, and the holder of the
+	// first and last nodes in its left and right links) is a nodeLinks
+	// inside the tree, so an empty tree allocates nothing. It is never
+	// taken for a node: iterators and parent links hold nodeLinks, and only
+	// real nodes are cast down to read their data. Empty subtrees are NULL,
+	// so no node but the root points at the header, and a swap relinks the
+	// two roots and nothing else. A stateless comparator or allocator takes
+	// no room: both are held through compressedStorage
 	template<class kT, class mapped_type, class value_type, class key_compare, class Allocator = std::allocator<nodeStruct<value_type> > >
 	class bst
+		: private compressedStorage<typename Allocator::template rebind<nodeStruct<value_type> >::other, 0>,
+		private compressedStorage<key_compare, 1>
 	{
 	public:
 		typedef kT													key_type;
@@ -231,88 +499,138 @@ namespace ft
 		typedef struct nodeStruct<value_type>											node;
 		typedef node*																	nodePtr;
 		typedef const node*																constNodePtr;
-		typedef typename ft::bstIterator<nodePtr, value_type>							nodeIterator;
-		typedef const typename ft::bstIterator<constNodePtr, const value_type>			nodeConstIterator;
+		typedef nodeLinks<value_type>*													linkPtr;
+		typedef const nodeLinks<value_type>*											constLinkPtr;
+		typedef typename ft::bstIterator<linkPtr, value_type>							nodeIterator;
+		typedef const typename ft::bstIterator<constLinkPtr, const value_type>			nodeConstIterator;
 		typedef ft::reverse_iterator<nodeIterator>		 								reverse_iterator;
 		typedef ft::reverse_iterator<nodeConstIterator> 								const_reverse_iterator;
 	private:
+		typedef compressedStorage<nodeAllocactor, 0>									allocatorStorage;
+		typedef compressedStorage<key_compare, 1>										compareStorage;
+
+		nodeLinks<value_type>															header;
 		size_t																			treeSize;
-		nodeAllocactor																	allocator;
-		key_compare																		comp;
 	public:
-		nodePtr																			nil;
 		nodePtr																			root;
 
 
 	// Create a node
-	nodePtr newNode(value_type val, nodePtr parent = NULL)
+	nodePtr newNode(value_type val, linkPtr parent)
 	{
-		nodePtr newNode = allocator.allocate(1);
-		allocator.construct(newNode, val);
-		if (!parent)
-		{
-			newNode->parent = NULL;
-			newNode->left = NULL;
-			newNode->right = NULL;
-		}
-		else
-		{
-			newNode->parent = parent;
-			newNode->left = nil;
-			newNode->right = nil;
-		}
+		instrumentation::record(events::TREE, events::ALLOCATIONS);
+		nodePtr newNode = allocator().allocate(1);
+		allocator().construct(newNode, val);
+		newNode->parent = parent;
+		newNode->left = NULL;
+		newNode->right = NULL;
 		return newNode;
 	}
 
+	private:
+		nodeAllocactor& allocator()
+		{
+			return allocatorStorage::get();
+		}
+
+		// the header lives in the tree: copying one would leave the root
+		// pointing at the header of the other
+		bst(const bst&);
+		bst& operator=(const bst&);
 
 	public:
-		bst(nodeAllocactor alloc = nodeAllocactor())
-			: treeSize(0), allocator(alloc), nil(newNode(value_type())), root(this->nil)
+		explicit bst(const key_compare& compare = key_compare(), const nodeAllocactor& alloc = nodeAllocactor())
+			: allocatorStorage(alloc), compareStorage(compare), treeSize(0), root(NULL)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst constructor called" << std::endl;
 		}
 
 
 		~bst()
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst destructor called" << std::endl; 
 			clear(root);
-			allocator.destroy(nil);
-			allocator.deallocate(nil, 1);
+		}
+
+		// end(), and the parent of the root
+		linkPtr endNode() const
+		{
+			return const_cast<linkPtr>(&header);
+		}
+
+		// the first node in key order, NULL when empty
+		nodePtr firstNode() const
+		{
+			return header.left;
+		}
+
+		// in-order successor of node below the header, NULL after the last
+		nodePtr nextNode(nodePtr node) const
+		{
+			if (node->right != NULL)
+				return min(node->right);
+			linkPtr parent = node->parent;
+			while (parent != endNode() && node == parent->right)
+			{
+				node = nodeOf(parent);
+				parent = node->parent;
+			}
+			return parentOf(node);
+		}
+
+		// the parent of node, NULL for the root
+		nodePtr parentOf(nodePtr node) const
+		{
+			return (node->parent == endNode() ? NULL : nodeOf(node->parent));
+		}
+
+		// every comparison of the tree goes through here, to be counted
+		template<typename Lhs, typename Rhs>
+		bool comp(const Lhs& lhs, const Rhs& rhs) const
+		{
+			instrumentation::record(events::TREE, events::COMPARISONS);
+			return compareStorage::get()(lhs, rhs);
+		}
+
+		key_compare key_comp() const
+		{
+			return compareStorage::get();
+		}
+
+		nodeAllocactor get_allocator() const
+		{
+			return allocatorStorage::get();
+		}
+
+		// takes the comparator and the allocator of other, for map::operator=
+		void assignPolicies(const bst& other)
+		{
+			compareStorage::get() = other.compareStorage::get();
+			allocatorStorage::get() = other.allocatorStorage::get();
 		}
 
 	//private:
 	public:
+		// frees the subtree below node bottom-up without recursion, so even a
+		// degenerate tree cannot overflow the stack
 		void clear(nodePtr node)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst clear() function called" << std::endl;
-			if (node != nil) {
-				clear(node->left);
-				clear(node->right);
-				deleteNode(node);
-			}
+			if (node == NULL)
+				return;
+			linkPtr parent = node->parent;
+			linkTo(node) = NULL;
+			node->parent = endNode();
+			size_t released = releaseNodes(node);
+			resizePath(parent, -static_cast<long>(released));
+			treeSize -= released;
+			updateExtremes();
 		}
 
 		void deleteNode(nodePtr node)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst deleteNode() function called" << std::endl;
-			if (node->parent != nil)
-			{
-				if (node == node->parent->left)
-					node->parent->left = nil;
-				else if (node == node->parent->right)
-					node->parent->right = nil;
-			}
-			else
-				root = nil;
-			if (BST_COMMENTS)
-				std::cout << "bst deleteNode() node to destroy -> first:" << node->data.first << std::endl;
-			allocator.destroy(node);
-			allocator.deallocate(node, 1);
+			linkTo(node) = NULL;
+			if (root == NULL)
+				updateExtremes();
+			allocator().destroy(node);
+			allocator().deallocate(node, 1);
 			treeSize--;
 		}
 
@@ -326,28 +644,29 @@ namespace ft
 			return(this->treeSize);
 		}
 
-		nodePtr insert(nodePtr node, value_type val, nodePtr parent)
+		nodePtr insert(nodePtr node, value_type val, linkPtr parent)
 		{
 			static nodePtr insertedNode = NULL;
 			static int depth = 0;
 			++depth;
-			if (node == nil)
+			if (node == NULL)
 			{
 				++treeSize;
-				if (root == nil)
+				if (root == NULL)
 				{
-					insertedNode = newNode(val, nil);
+					insertedNode = newNode(val, endNode());
 					root = insertedNode;
-					nil->left = root;
-					nil->right = root;
+					header.left = root;
+					header.right = root;
 					--depth;
 					return (root);
 				}
 				insertedNode = newNode(val, parent);
-				if (comp(insertedNode->data.first, nil->left->data.first))
-					nil->left = insertedNode;
-				else if (comp(nil->right->data.first, insertedNode->data.first))
-					nil->right = insertedNode;
+				resizePath(parent, 1);
+				if (comp(insertedNode->data.first, header.left->data.first))
+					header.left = insertedNode;
+				else if (comp(header.right->data.first, insertedNode->data.first))
+					header.right = insertedNode;
 				--depth;
 				return (insertedNode);
 			}
@@ -370,68 +689,224 @@ namespace ft
 		void insert (InputIterator first, InputIterator last)
 		{
 			for ( ; first != last; ++first)
-				insert(this->root, *first, this->root->parent);
+				insert(this->root, *first, endNode());
 		}
 
-		void erase (nodePtr position)
+		void erase (linkPtr position)
 		{
-			if (position == nil)
+			if (position == endNode())
 				return;
-			// two children
-			if (position->left != nil && position->right != nil)
+			nodePtr erased = nodeOf(position);
+			unlinkNode(erased);
+			allocator().destroy(erased);
+			allocator().deallocate(erased, 1);
+		}
+
+		// takes position out of the tree without freeing it; the node is left
+		// detached (NULL links) for a node handle
+		nodePtr extractNode(linkPtr position)
+		{
+			nodePtr extracted = nodeOf(position);
+			unlinkNode(extracted);
+			extracted->parent = NULL;
+			extracted->left = NULL;
+			extracted->right = NULL;
+			return extracted;
+		}
+
+		// links a detached node into the tree without allocating; returns the
+		// node holding its key and whether it was linked (false: key taken)
+		ft::pair<nodePtr, bool> insertNode(nodePtr position)
+		{
+			linkPtr parent = endNode();
+			nodePtr* link = &root;
+			while (*link != NULL)
 			{
-				nodePtr minOfNode = min(position->right);
-				if (position != root)
+				nodePtr current = *link;
+				parent = current;
+				if (comp(position->data.first, current->data.first))
+					link = &current->left;
+				else if (comp(current->data.first, position->data.first))
+					link = &current->right;
+				else
+					return ft::make_pair(current, false);
+			}
+			*link = position;
+			position->parent = parent;
+			position->left = NULL;
+			position->right = NULL;
+#if BST_ORDER_STATISTICS
+			position->subtreeSize = 1;
+#endif
+			resizePath(parent, 1);
+			if (parent == endNode() || comp(position->data.first, header.left->data.first))
+				header.left = position;
+			if (parent == endNode() || comp(header.right->data.first, position->data.first))
+				header.right = position;
+			++treeSize;
+			return ft::make_pair(position, true);
+		}
+
+		// moves every node of other whose key is not in this tree yet; the rest
+		// stay in other. Nodes are relinked, never copied, and nothing is
+		// allocated: the walks keep their state in the links of the nodes
+		// they are done with. A small other is inserted node by node,
+		// otherwise both trees are rebuilt balanced from their merged key order
+		void merge(bst& other)
+		{
+			if (&other == this || other.treeSize == 0)
+				return;
+			if (other.treeSize * 16 < treeSize)
+				mergeByInsertion(other);
+			else
+				mergeByRebuild(other);
+		}
+
+		// O(size of other * height). Nodes go in parents first (pre-order) so
+		// the inserted keys keep the shape they had in other: inserting leaves
+		// first would chain them up in key order. The subtrees still to go are
+		// stacked through the parent links of their roots, which no longer
+		// lead anywhere once other is emptied
+		void mergeByInsertion(bst& other)
+		{
+			nodePtr pending = other.root;
+			pending->parent = NULL;
+			other.abandonNodes();
+			while (pending != NULL)
+			{
+				nodePtr node = pending;
+				pending = nodeOf(node->parent);
+				if (node->right != NULL)
 				{
-					if (position == position->parent->right)
-						position->parent->right = position->right;
-					else if (position == position->parent->left)
-						position->parent->left = position->right;
-					position->right->parent= position->parent;
+					node->right->parent = pending;
+					pending = node->right;
 				}
-				else
+				if (node->left != NULL)
 				{
-					
-					position->right->parent = nil;
-					root = position->right;
+					node->left->parent = pending;
+					pending = node->left;
 				}
-				position->left->parent = minOfNode;
-				minOfNode->left = position->left;
-			} //no children
-			else if (position->left == nil && position->right == nil)
-			{
-				if (position == root)
-					root = nil;
-				if (position != root && position == position->parent->left)
-					position->parent->left = nil;
-				else if (position != root && position == position->parent->right)
-					position->parent->right = nil;
-			}
-			else // one child
-			{
-				nodePtr child = (position->left == nil ? position->right : position->left);
-				if (position == root)
+				if (!insertNode(node).second)
+					other.insertNode(node);
+			}
+		}
+
+		// O(size + size of other): both trees are walked in order and the
+		// walks merged into two lists, kept and rejected nodes, each tree is
+		// then rebuilt balanced from its list. A walk only reads the right and
+		// parent links of the nodes it has passed, so the lists go through
+		// their left links
+		void mergeByRebuild(bst& other)
+		{
+			nodePtr mine = firstNode();
+			nodePtr theirs = other.firstNode();
+			nodePtr kept = NULL;
+			nodePtr rejected = NULL;
+			nodePtr* keptTail = &kept;
+			nodePtr* rejectedTail = &rejected;
+			size_t keptCount = 0;
+			size_t rejectedCount = 0;
+			while (mine != NULL || theirs != NULL)
+			{
+				nodePtr node;
+				if (theirs == NULL || (mine != NULL && comp(mine->data.first, theirs->data.first)))
 				{
-					child->parent = nil;
-					root = child;
+					node = mine;
+					mine = nextNode(mine);
 				}
-				else if (position == position->parent->left)
+				else if (mine == NULL || comp(theirs->data.first, mine->data.first))
 				{
-					position->parent->left = child;
-					child->parent = position->parent;
+					node = theirs;
+					theirs = other.nextNode(theirs);
 				}
-				else if (position == position->parent->right)
+				else
 				{
-					position->parent->right = child;
-					child->parent = position->parent;
+					node = mine;
+					mine = nextNode(mine);
+					*rejectedTail = theirs;
+					rejectedTail = &theirs->left;
+					++rejectedCount;
+					theirs = other.nextNode(theirs);
 				}
+				*keptTail = node;
+				keptTail = &node->left;
+				++keptCount;
 			}
-			if (position == nil->right)
-				position->left != nil ? nil->right = position->left : nil->left = position->parent;
-			if (position == nil->left)
-				position->right != nil ? nil->left = position->right : nil->left = position->parent;
-			allocator.destroy(position);
-			allocator.deallocate(position, 1);
+			adoptSubtree(buildFromList(kept, keptCount), keptCount);
+			other.adoptSubtree(other.buildFromList(rejected, rejectedCount), rejectedCount);
+		}
+
+		// builds a perfectly balanced subtree, shaped like buildSubtree, from
+		// the first count nodes of a list linked through their left links, and
+		// moves head past them. O(count), the recursion is log2(count) deep
+		nodePtr buildFromList(nodePtr& head, size_t count)
+		{
+			if (count == 0)
+				return NULL;
+			nodePtr left = buildFromList(head, count / 2);
+			nodePtr node = head;
+			head = head->left;
+			node->left = left;
+			if (left != NULL)
+				left->parent = node;
+			node->right = buildFromList(head, count - count / 2 - 1);
+			if (node->right != NULL)
+				node->right->parent = node;
+#if BST_ORDER_STATISTICS
+			node->subtreeSize = count;
+#endif
+			return node;
+		}
+
+		// appends the nodes of the tree to out in key order, O(size)
+		void collectNodes(ft::vector<nodePtr>& out) const
+		{
+			for (nodePtr node = firstNode(); node != NULL; node = nextNode(node))
+				out.push_back(node);
+		}
+
+		// relinks the tree around position, which keeps its own links
+		void unlinkNode(nodePtr position)
+		{
+			resizePath(position->parent, -1);
+			// two children: the in-order successor takes the place of position.
+			// Hanging position->left below the successor instead would be fewer
+			// writes but makes the tree a little deeper on every erase
+			if (position->left != NULL && position->right != NULL)
+			{
+				nodePtr successorNode = min(position->right);
+#if BST_ORDER_STATISTICS
+				for (linkPtr node = successorNode->parent; node != position; node = node->parent)
+					--node->subtreeSize;
+				successorNode->subtreeSize = position->subtreeSize - 1;
+#endif
+				if (successorNode != position->right)
+				{
+					nodePtr successorParent = nodeOf(successorNode->parent);
+					successorParent->left = successorNode->right;
+					if (successorNode->right != NULL)
+						successorNode->right->parent = successorParent;
+					successorNode->right = position->right;
+					position->right->parent = successorNode;
+				}
+				successorNode->left = position->left;
+				position->left->parent = successorNode;
+				successorNode->parent = position->parent;
+				linkTo(position) = successorNode;
+			}
+			else // no child or one
+			{
+				nodePtr child = (position->left == NULL ? position->right : position->left);
+				if (child != NULL)
+					child->parent = position->parent;
+				linkTo(position) = child;
+			}
+			// an extreme node has at most one child: the new extreme is in that
+			// child's subtree or is the parent
+			if (position == header.right)
+				header.right = (position->left != NULL ? max(position->left) : parentOf(position));
+			if (position == header.left)
+				header.left = (position->right != NULL ? min(position->right) : parentOf(position));
 			treeSize--;
 		}
 
@@ -440,39 +915,130 @@ namespace ft
 			return (this->treeSize);
 		}
 
+		// adds delta to the subtree size of node and all its ancestors
+		void resizePath(linkPtr node, long delta)
+		{
+#if BST_ORDER_STATISTICS
+			for (; node != endNode(); node = node->parent)
+				node->subtreeSize += delta;
+#else
+			(void)node;
+			(void)delta;
+#endif
+		}
+
+		// one pre-order walk along the parent links: O(n) time, no
+		// recursion and no stack, however deep the tree
+		map_stats shapeStats() const
+		{
+			map_stats stats;
+			size_t depthSum = 0;
+			size_t depth = 0;
+			linkPtr from = endNode();
+			nodePtr walk = root;
+			while (walk != NULL)
+			{
+				nodePtr next;
+				if (from == walk->parent)
+				{
+					if (depth == stats.depth_histogram.size())
+						stats.depth_histogram.push_back(0);
+					++stats.depth_histogram[depth];
+					depthSum += depth;
+					next = (walk->left != NULL ? walk->left : walk->right);
+				}
+				else if (from == walk->left)
+					next = walk->right;
+				else
+					next = NULL;
+				from = walk;
+				if (next != NULL)
+				{
+					walk = next;
+					++depth;
+				}
+				else
+				{
+					walk = parentOf(walk);
+					--depth;
+				}
+			}
+			stats.node_count = treeSize;
+			stats.height = stats.depth_histogram.size();
+			stats.max_depth = (stats.height ? stats.height - 1 : 0);
+			if (treeSize)
+				stats.average_depth = static_cast<double>(depthSum) / treeSize;
+			for (size_t levels = treeSize; levels; levels >>= 1)
+				++stats.balanced_height;
+			stats.node_bytes = treeSize * sizeof(node);
+			stats.bytes_used = stats.node_bytes;
+			stats.average_comparisons = (treeSize ? stats.average_depth + 1 : 0);
+			return stats;
+		}
+
+		// number of keys strictly less than k
+		size_t rank(const key_type& k) const
+		{
+			size_t lessCount = 0;
+			nodePtr node = root;
+			while (node != NULL)
+			{
+				if (comp(k, node->data.first))
+					node = node->left;
+				else if (comp(node->data.first, k))
+				{
+					lessCount += subtreeSize(node->left) + 1;
+					node = node->right;
+				}
+				else
+					return lessCount + subtreeSize(node->left);
+			}
+			return lessCount;
+		}
+
+		nodeIterator select(size_t idx)
+		{
+			return nodeIterator(selectNode(static_cast<linkPtr>(root), endNode(), idx));
+		}
+
+		nodeConstIterator select(size_t idx) const
+		{
+			return nodeConstIterator(selectNode(static_cast<constLinkPtr>(root), static_cast<constLinkPtr>(endNode()), idx));
+		}
+
 		bool empty() const
 		{
-			return (this->root == nil);
+			return (this->root == NULL);
 		}
 
 		nodeIterator begin() throw()
 		{
-			return nodeIterator(min(this->root));
+			return nodeIterator(root != NULL ? header.left : endNode());
 		}
 
 		nodeConstIterator begin() const throw()
 		{
-			return nodeConstIterator(min(this->root));
+			return nodeConstIterator(root != NULL ? header.left : endNode());
 		}
 
 		nodeIterator end() throw()
 		{
-			return nodeIterator(this->nil);
+			return nodeIterator(endNode());
 		}
 
 		nodeConstIterator end() const throw()
 		{
-			return nodeConstIterator(this->nil);
+			return nodeConstIterator(endNode());
 		}
 
 		reverse_iterator rbegin() throw()
 		{
-			return (reverse_iterator(nodeIterator(nil)));
+			return (reverse_iterator(end()));
 		}
 
 		const_reverse_iterator rbegin() const throw()
 		{
-			return (const_reverse_iterator(nodeConstIterator(max(this->root))));
+			return (const_reverse_iterator(end()));
 		}
 
 		reverse_iterator rend() throw()
@@ -487,9 +1053,12 @@ namespace ft
 
 		nodeIterator find (nodePtr node, const key_type& k)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst find() function called" << std::endl;
-			if (k == node->data.first || node == nil)
+			if (node == root)
+				instrumentation::record(events::TREE, events::LOOKUPS);
+			instrumentation::record(events::TREE, events::NODES_VISITED, node != NULL);
+			if (node == NULL)
+				return end();
+			if (k == node->data.first)
 				return nodeIterator(node);
 			if (comp(k,node->data.first))
 				return nodeIterator(find(node->left, k));
@@ -499,9 +1068,12 @@ namespace ft
 
 		nodeConstIterator find (const nodePtr node, const key_type& k) const
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst find() function called" << std::endl;
-			if (k == node->data.first || node == nil)
+			if (node == root)
+				instrumentation::record(events::TREE, events::LOOKUPS);
+			instrumentation::record(events::TREE, events::NODES_VISITED, node != NULL);
+			if (node == NULL)
+				return end();
+			if (k == node->data.first)
 				return nodeConstIterator(node);
 			if (comp(k,node->data.first))
 				return nodeConstIterator(find(node->left, k));
@@ -509,148 +1081,613 @@ namespace ft
 				return nodeConstIterator(find(node->right, k));
 		}
 
-		nodeIterator lower_bound(nodePtr node, const key_type& k)
+		// lower bound of k searched from finger, the lower bound of a key not
+		// greater than k (NULL: search from the root); NULL when every key is
+		// less than k. Climbs only until the subtree around the finger can
+		// hold k, then descends, so close keys cost O(log distance) instead
+		// of O(height)
+		nodePtr fingerLowerBound(nodePtr finger, const key_type& k) const
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst lower_bound() function called" << std::endl;
-			nodePtr x = node;
-			nodePtr y = min(root);
-			while (x != nil)
+			nodePtr bound = NULL;
+			nodePtr node = root;
+			if (finger != NULL)
 			{
-				if (BST_COMMENTS)
-					std::cout << "bst lower_bound() in while" << std::endl;
-				if (k == x->data.first)
+				if (!comp(finger->data.first, k))
+					return finger;
+				node = finger;
+				while (node != root)
 				{
-					if (BST_COMMENTS)
-						std::cout << "k == x->data.first => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
-					return nodeIterator(x);
+					nodePtr parent = nodeOf(node->parent);
+					if (node == parent->left && comp(k, parent->data.first))
+					{
+						bound = parent;
+						break;
+					}
+					node = parent;
 				}
-				else if (comp(k, x->data.first))
+			}
+			while (node != NULL)
+			{
+				if (comp(node->data.first, k))
+					node = node->right;
+				else if (comp(k, node->data.first))
 				{
-					if (BST_COMMENTS)
-						std::cout << "bst lower_bound() in while if" << std::endl;
-					y = x;
-					x = x->left;
+					bound = node;
+					node = node->left;
 				}
 				else
+					return node;
+			}
+			return bound;
+		}
+
+		// writes Iterator(lower bound) of every key of an ascending batch to
+		// out; with exact the node holding the key, or end, instead. Each search
+		// starts from the previous result, a key smaller than the one before it
+		// starts over from the root
+		template<typename Iterator, typename ForwardIterator, typename OutputIterator>
+		OutputIterator sortedSearch(ForwardIterator first, ForwardIterator last, OutputIterator out, bool exact) const
+		{
+			nodePtr finger = NULL;
+			for (ForwardIterator previous = first; first != last; previous = first, ++first, ++out)
+			{
+				if (comp(*first, *previous))
+					finger = NULL;
+				finger = fingerLowerBound(finger, *first);
+				if (finger == NULL || (exact && comp(*first, finger->data.first)))
+					*out = Iterator(endNode());
+				else
+					*out = Iterator(finger);
+			}
+			return out;
+		}
+
+		// looks up n keys in any order, writing Iterator(node) or Iterator(end)
+		// to results. BST_BATCH_GROUP lookups advance one level each in turn
+		// (asynchronous memory access chaining) and prefetch the child they
+		// move to, so their cache misses overlap instead of being waited for
+		// one after the other. A finished lookup takes the next key
+		template<typename Iterator>
+		void findBatch(const key_type* keys, size_t n, Iterator* results) const
+		{
+			size_t slotKey[BST_BATCH_GROUP];
+			nodePtr slotNode[BST_BATCH_GROUP];
+			instrumentation::record(events::TREE, events::LOOKUPS, n);
+			size_t next = 0;
+			size_t active = 0;
+			for (; active < BST_BATCH_GROUP && next < n; ++active, ++next)
+			{
+				slotKey[active] = next;
+				slotNode[active] = root;
+			}
+			while (active > 0)
+			{
+				for (size_t slot = 0; slot < active;)
 				{
-					if (BST_COMMENTS)
-						std::cout << "BEFORE => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
-					x = x->right;
-					if (BST_COMMENTS)
-						std::cout << "AFTER => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
+					nodePtr node = slotNode[slot];
+					const key_type& k = keys[slotKey[slot]];
+					instrumentation::record(events::TREE, events::NODES_VISITED, node != NULL);
+					if (node != NULL && comp(k, node->data.first))
+						node = node->left;
+					else if (node != NULL && comp(node->data.first, k))
+						node = node->right;
+					else
+					{
+						if (node != NULL)
+							results[slotKey[slot]] = Iterator(node);
+						else
+							results[slotKey[slot]] = Iterator(endNode());
+						if (next < n)
+						{
+							slotKey[slot] = next++;
+							slotNode[slot] = root;
+							++slot;
+						}
+						else
+						{
+							// the last active lookup moves into this slot and
+							// runs next
+							--active;
+							slotKey[slot] = slotKey[active];
+							slotNode[slot] = slotNode[active];
+						}
+						continue;
+					}
+					if (node != NULL)
+						__builtin_prefetch(node);
+					slotNode[slot] = node;
+					++slot;
 				}
 			}
-			if (BST_COMMENTS)
-				std::cout << "First value: "<< y->data.first << " and second value: " << y->data.second << std::endl;
-			if (x == nil && !(comp(k, y->data.first)))
-				return nodeIterator(x);
-			else
-				return nodeIterator(y);
 		}
-		
+
+		// the first node whose key is not less than k, NULL if none
+		nodePtr lowerBoundNode(nodePtr node, const key_type& k) const
+		{
+			instrumentation::record(events::TREE, events::LOOKUPS);
+			nodePtr bound = NULL;
+			while (node != NULL)
+			{
+				instrumentation::record(events::TREE, events::NODES_VISITED);
+				if (k == node->data.first)
+					return node;
+				else if (comp(k, node->data.first))
+				{
+					bound = node;
+					node = node->left;
+				}
+				else
+					node = node->right;
+			}
+			return bound;
+		}
+
+		// the first node whose key is greater than k, NULL if none
+		nodePtr upperBoundNode(nodePtr node, const key_type& k) const
+		{
+			instrumentation::record(events::TREE, events::LOOKUPS);
+			nodePtr bound = NULL;
+			while (node != NULL)
+			{
+				instrumentation::record(events::TREE, events::NODES_VISITED);
+				if (comp(k, node->data.first))
+				{
+					bound = node;
+					node = node->left;
+				}
+				else
+					node = node->right;
+			}
+			return bound;
+		}
+
+		nodeIterator lower_bound(nodePtr node, const key_type& k)
+		{
+			nodePtr bound = lowerBoundNode(node, k);
+			return (bound != NULL ? nodeIterator(bound) : end());
+		}
+
 		nodeConstIterator lower_bound (const nodePtr node, const key_type& k) const
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst lower_bound() const function called" << std::endl;
-			nodePtr x = node;
-			nodePtr y = min(root);
-			while (x != nil)
+			nodePtr bound = lowerBoundNode(node, k);
+			return (bound != NULL ? nodeConstIterator(bound) : end());
+		}
+
+		nodeIterator upper_bound(nodePtr node, const key_type& k)
+		{
+			nodePtr bound = upperBoundNode(node, k);
+			return (bound != NULL ? nodeIterator(bound) : end());
+		}
+
+		nodeConstIterator upper_bound (const nodePtr node, const key_type& k) const
+		{
+			nodePtr bound = upperBoundNode(node, k);
+			return (bound != NULL ? nodeConstIterator(bound) : end());
+		}
+
+		// O(1) and no-throw: the root is the only node linked to the header
+		void swap(bst& x)
+		{
+			if (&x == this)
+				return;
+			std::swap(this->root, x.root);
+			std::swap(this->treeSize, x.treeSize);
+			std::swap(this->header.left, x.header.left);
+			std::swap(this->header.right, x.header.right);
+			std::swap(compareStorage::get(), x.compareStorage::get());
+			std::swap(allocatorStorage::get(), x.allocatorStorage::get());
+			if (root != NULL)
+				root->parent = endNode();
+			if (x.root != NULL)
+				x.root->parent = x.endNode();
+		}
+
+		// clones the shape of the tree rooted at nodeFrom into this empty tree,
+		// walking both trees in lockstep through the parent links
+		void copyTree(nodePtr nodeFrom)
+		{
+			if (nodeFrom == NULL)
+				return;
+			nodePtr from = nodeFrom;
+			nodePtr to = newNode(from->data, endNode());
+			root = to;
+			treeSize = 1;
+			while (true)
 			{
-				if (BST_COMMENTS)
-					std::cout << "bst lower_bound() const in while" << std::endl;
-				if (k == x->data.first)
+#if BST_ORDER_STATISTICS
+				to->subtreeSize = from->subtreeSize;
+#endif
+				if (from->left != NULL && to->left == NULL)
 				{
-					if (BST_COMMENTS)
-						std::cout << "k == x->data.first => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
-					return nodeConstIterator(x);
+					to->left = newNode(from->left->data, to);
+					from = from->left;
+					to = to->left;
+					++treeSize;
 				}
-				else if (comp(k, x->data.first))
+				else if (from->right != NULL && to->right == NULL)
 				{
-					if (BST_COMMENTS)
-						std::cout << "bst lower_bound() const in while if" << std::endl;
-					y = x;
-					x = x->left;
+					to->right = newNode(from->right->data, to);
+					from = from->right;
+					to = to->right;
+					++treeSize;
 				}
+				else if (from == nodeFrom)
+					break;
 				else
 				{
-					if (BST_COMMENTS)
-						std::cout << "BEFORE => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
-					x = x->right;
-					if (BST_COMMENTS)
-						std::cout << "AFTER => First value: "<< x->data.first << " and second value: " << x->data.second << std::endl;
+					from = nodeOf(from->parent);
+					to = nodeOf(to->parent);
 				}
 			}
-			if (BST_COMMENTS)
-				std::cout << "First value: "<< y->data.first << " and second value: " << y->data.second << std::endl;
-			if (x == nil && !(comp(k, y->data.first)))
-				return nodeConstIterator(x);
+			updateExtremes();
+		}
+
+		// points the header at the first and the last node again
+		void updateExtremes()
+		{
+			header.left = (root != NULL ? min(root) : NULL);
+			header.right = (root != NULL ? max(root) : NULL);
+		}
+
+		// recomputes the subtree sizes from node up to its root, O(height)
+		void resizeSpine(linkPtr node)
+		{
+#if BST_ORDER_STATISTICS
+			for (; node != endNode(); node = node->parent)
+				node->subtreeSize = 1 + subtreeSize(node->left) + subtreeSize(node->right);
+#else
+			(void)node;
+#endif
+		}
+
+		// splits the subtree at node into the keys less than k and the keys not
+		// less than k; only the nodes on the search path for k are relinked, so
+		// the cost is O(height) whatever the size of the two halves. Both
+		// halves hang from the header
+		void split(nodePtr node, const key_type& k, nodePtr& less, nodePtr& notLess)
+		{
+			nodePtr* lessHook = &less;
+			nodePtr* notLessHook = &notLess;
+			linkPtr lessParent = endNode();
+			linkPtr notLessParent = endNode();
+			while (node != NULL)
+			{
+				if (comp(node->data.first, k))
+				{
+					*lessHook = node;
+					node->parent = lessParent;
+					lessParent = node;
+					lessHook = &node->right;
+					node = node->right;
+				}
+				else
+				{
+					*notLessHook = node;
+					node->parent = notLessParent;
+					notLessParent = node;
+					notLessHook = &node->left;
+					node = node->left;
+				}
+			}
+			*lessHook = NULL;
+			*notLessHook = NULL;
+			resizeSpine(lessParent);
+			resizeSpine(notLessParent);
+		}
+
+		// joins two subtrees where every key of left is less than every key of
+		// right: the maximum of left is taken out and becomes the new root, so
+		// the height is max(left, right) + 1 instead of their sum. O(height of left)
+		nodePtr join(nodePtr left, nodePtr right)
+		{
+			if (left == NULL || right == NULL)
+			{
+				nodePtr joined = (left == NULL ? right : left);
+				if (joined != NULL)
+					joined->parent = endNode();
+				return joined;
+			}
+			left->parent = endNode();
+			nodePtr pivot = max(left);
+			resizePath(pivot->parent, -1);
+			// the maximum has no right child: its left subtree takes its place
+			if (pivot->left != NULL)
+				pivot->left->parent = pivot->parent;
+			if (pivot == left)
+				left = pivot->left;
 			else
-				return nodeConstIterator(y);
+				nodeOf(pivot->parent)->right = pivot->left;
+			pivot->left = left;
+			if (left != NULL)
+				left->parent = pivot;
+			pivot->right = right;
+			right->parent = pivot;
+			pivot->parent = endNode();
+#if BST_ORDER_STATISTICS
+			pivot->subtreeSize = 1 + subtreeSize(left) + right->subtreeSize;
+#endif
+			return pivot;
 		}
 
-	nodeIterator upper_bound(nodePtr node, const key_type& k)
+		// unlinks the nodes of [first, last) from the tree and returns them as
+		// one subtree hanging from the header; treeSize is left to the caller
+		nodePtr detachRange(linkPtr first, linkPtr last)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst upper_bound() function called" << std::endl;
-			if (comp(k, nil->left->data.first))
-				return nodeIterator(nil->left);
-			else if (!comp(k, nil->right->data.first))
-				return nodeIterator(nil);
-			while (!(node->left == nil && node->right == nil))
+			if (first == last)
+				return NULL;
+			nodePtr less;
+			nodePtr rest;
+			nodePtr middle;
+			nodePtr greater;
+			split(root, nodeOf(first)->data.first, less, rest);
+			if (last == endNode())
 			{
-				if (node->data.first == k)
-					return ++nodeIterator(node);
-				if (node->left != nil && comp(k, node->data.first))
+				middle = rest;
+				greater = NULL;
+			}
+			else
+				split(rest, nodeOf(last)->data.first, middle, greater);
+			root = join(less, greater);
+			updateExtremes();
+			return middle;
+		}
+
+		// frees a subtree hanging from the header bottom-up without relinking
+		// the rest of the tree
+		size_t releaseNodes(nodePtr node)
+		{
+			size_t released = 0;
+			while (node != NULL)
+			{
+				if (node->left != NULL)
 					node = node->left;
-				else if (node->right != nil && !comp(k, node->right->data.first))
+				else if (node->right != NULL)
 					node = node->right;
 				else
-					break;
+				{
+					nodePtr parent = parentOf(node);
+					if (parent != NULL)
+						(parent->left == node ? parent->left : parent->right) = NULL;
+					allocator().destroy(node);
+					allocator().deallocate(node, 1);
+					++released;
+					node = parent;
+				}
 			}
-			return ++nodeIterator(node);
-			
+			return released;
 		}
-		
-		nodeConstIterator upper_bound (const nodePtr node, const key_type& k) const
+
+		// O(height + k) erase of [first, last)
+		void eraseRange(linkPtr first, linkPtr last)
+		{
+			treeSize -= releaseNodes(detachRange(first, last));
+		}
+
+		// moves the nodes of [first, last) into the empty tree other without
+		// copying them: only the root of the range changes headers
+		void extractRange(linkPtr first, linkPtr last, bst& other)
 		{
-			if (BST_COMMENTS)
-				std::cout << "bst upper_bound() const function called" << std::endl;
-			nodePtr returnNode = node;
-			if (comp(k, nil->left->data.first))
-				return nodeConstIterator(nil->left);
-			else if (!comp(k, nil->right->data.first))
-				return nodeConstIterator(nil);
-			while (!(returnNode->left == nil && returnNode->right == nil))
-			{
-				if (returnNode->data.first == k)
-					return nodeConstIterator(++nodeIterator(returnNode));
-				if (returnNode->left != nil && comp(k, returnNode->data.first))
-					returnNode = returnNode->left;
-				else if (returnNode->right != nil && !comp(k, returnNode->right->data.first))
-					returnNode = returnNode->right;
+			nodePtr middle = detachRange(first, last);
+			if (middle == NULL)
+				return;
+			middle->parent = other.endNode();
+			other.root = middle;
+			other.updateExtremes();
+#if BST_ORDER_STATISTICS
+			size_t moved = middle->subtreeSize;
+#else
+			size_t moved = 0;
+			for (nodePtr node = other.firstNode(); node != NULL; node = other.nextNode(node))
+				++moved;
+#endif
+			other.treeSize = moved;
+			treeSize -= moved;
+		}
+
+		// builds a perfectly balanced subtree from count nodes sorted by key:
+		// with copy each value gets a new node, otherwise the nodes themselves
+		// are relinked (they may come from other trees). O(count)
+		nodePtr buildSubtree(nodePtr* nodes, size_t count, linkPtr parent, bool copy)
+		{
+			if (count == 0)
+				return NULL;
+			size_t mid = count / 2;
+			nodePtr node = copy ? newNode(nodes[mid]->data, parent) : nodes[mid];
+			node->parent = parent;
+			node->left = buildSubtree(nodes, mid, node, copy);
+			node->right = buildSubtree(nodes + mid + 1, count - mid - 1, node, copy);
+#if BST_ORDER_STATISTICS
+			node->subtreeSize = count;
+#endif
+			return node;
+		}
+
+		// makes a subtree built from count nodes the content of this empty tree
+		void adoptSubtree(nodePtr subtree, size_t count)
+		{
+			root = subtree;
+			treeSize = count;
+			if (subtree != NULL)
+				subtree->parent = endNode();
+			updateExtremes();
+		}
+
+		void buildBalanced(nodePtr* nodes, size_t count, bool copy)
+		{
+			adoptSubtree(buildSubtree(nodes, count, endNode(), copy), count);
+		}
+
+		// empties the tree without freeing its nodes, once they have been moved
+		// into another tree
+		void abandonNodes()
+		{
+			root = NULL;
+			header.left = NULL;
+			header.right = NULL;
+			treeSize = 0;
+		}
+
+		// frees a node that is linked nowhere any more
+		void freeNode(nodePtr node)
+		{
+			allocator().destroy(node);
+			allocator().deallocate(node, 1);
+		}
+
+	/******************** PUBLISHED TREE ********************/
+
+		// Lock-free readers (concurrent_map.hpp) go down from root through
+		// the left and right links only, with acquire loads, while one
+		// writer changes the tree with the operations below. Those never
+		// change a node a reader may be on: a node is fully built before
+		// one release store links it in, and nodes taken out keep their
+		// links and are handed back to be freed once no reader can hold
+		// them. The parent links, extremes and sizes are the writer's own.
+		// One thing a reader can still see is a key gone for a moment: see
+		// erasePublished.
+
+		static nodePtr readLink(nodePtr const& link)
+		{
+			return __atomic_load_n(&link, __ATOMIC_ACQUIRE);
+		}
+
+		static void publishLink(nodePtr& link, nodePtr node)
+		{
+			__atomic_store_n(&link, node, __ATOMIC_RELEASE);
+		}
+
+		// the reader side of find, NULL when k is not there. Both children
+		// are loaded before the comparison, from the line the key is on: the
+		// acquire loads keep the compiler from doing it, and waiting for the
+		// comparison to pick one costs a third of a lookup
+		nodePtr findPublished(const key_type& k) const
+		{
+			nodePtr node = readLink(root);
+			while (node != NULL)
+			{
+				nodePtr left = readLink(node->left);
+				nodePtr right = readLink(node->right);
+				bool less = comp(k, node->data.first);
+				if (!less && !comp(node->data.first, k))
+					return node;
+				node = (less ? left : right);
+			}
+			return NULL;
+		}
+
+		// returns the node holding the key of val and whether it is new
+		ft::pair<nodePtr, bool> insertPublished(const value_type& val)
+		{
+			linkPtr parent = endNode();
+			nodePtr* link = &root;
+			while (*link != NULL)
+			{
+				nodePtr current = *link;
+				parent = current;
+				if (comp(val.first, current->data.first))
+					link = &current->left;
+				else if (comp(current->data.first, val.first))
+					link = &current->right;
 				else
-					break;
+					return ft::make_pair(current, false);
 			}
-			return nodeConstIterator(++nodeIterator(returnNode));
+			nodePtr node = newNode(val, parent);
+			resizePath(parent, 1);
+			if (parent == endNode() || comp(node->data.first, header.left->data.first))
+				header.left = node;
+			if (parent == endNode() || comp(header.right->data.first, node->data.first))
+				header.right = node;
+			++treeSize;
+			publishLink(*link, node);
+			return ft::make_pair(node, true);
 		}
 
-		void swap(bst& x)
+		// puts a new node holding val in the place of position, which has
+		// the same key; returns position, to be freed
+		nodePtr replacePublished(nodePtr position, const value_type& val)
 		{
-			std::swap(this->root, x.root);
-			std::swap(this->treeSize, x.treeSize);
-			std::swap(this->nil, x.nil);
-			std::swap(this->comp, x.comp);
-			std::swap(this->allocator, x.allocator);
+			nodePtr node = newNode(val, position->parent);
+			node->left = position->left;
+			node->right = position->right;
+#if BST_ORDER_STATISTICS
+			node->subtreeSize = position->subtreeSize;
+#endif
+			adoptChildren(node);
+			if (header.left == position)
+				header.left = node;
+			if (header.right == position)
+				header.right = node;
+			publishLink(linkTo(position), node);
+			return position;
 		}
 
-		void copyTree(nodePtr nodeFrom, nodePtr nodeTo, nodePtr nilFrom)
+		// takes position out; returns the nodes to free once no reader can
+		// hold them: position, and the successor copied into its place when
+		// it had two children (the second is NULL otherwise). The copy is
+		// linked first, then the successor unlinked from below: a reader
+		// already past position on its way down to the successor misses its
+		// key, though it never left the tree. hide() is called right before
+		// that unlink, whose release store publishes what hide() wrote, so
+		// such a reader can tell and look again from the root
+		template<typename Hide>
+		ft::pair<nodePtr, nodePtr> erasePublished(nodePtr position, Hide hide)
 		{
-			if (nodeFrom == nilFrom)
-				return;
-			insert(nodeTo, nodeFrom->data, nodeTo->parent);
-			copyTree(nodeFrom->left, nodeTo->left, nilFrom);
-			copyTree(nodeFrom->right, nodeTo->right, nilFrom);
+			if (position->left == NULL || position->right == NULL)
+			{
+				nodePtr child = (position->left == NULL ? position->right : position->left);
+				resizePath(position->parent, -1);
+				if (child != NULL)
+					child->parent = position->parent;
+				if (position == header.left)
+					header.left = (child != NULL ? min(child) : parentOf(position));
+				if (position == header.right)
+					header.right = (child != NULL ? max(child) : parentOf(position));
+				--treeSize;
+				publishLink(linkTo(position), child);
+				return ft::make_pair(position, nodePtr());
+			}
+			nodePtr successorNode = min(position->right);
+			nodePtr copy = newNode(successorNode->data, position->parent);
+			copy->left = position->left;
+			copy->right = (successorNode == position->right ? successorNode->right : position->right);
+#if BST_ORDER_STATISTICS
+			for (linkPtr node = successorNode->parent; node != position; node = node->parent)
+				--node->subtreeSize;
+			copy->subtreeSize = position->subtreeSize - 1;
+#endif
+			resizePath(position->parent, -1);
+			adoptChildren(copy);
+			if (header.right == successorNode)
+				header.right = copy;
+			--treeSize;
+			publishLink(linkTo(position), copy);
+			if (successorNode != position->right)
+			{
+				nodePtr successorParent = nodeOf(successorNode->parent);
+				if (successorNode->right != NULL)
+					successorNode->right->parent = successorParent;
+				hide();
+				publishLink(successorParent->left, successorNode->right);
+			}
+			return ft::make_pair(position, successorNode);
+		}
+
+	private:
+		// the link that leads to node: root, or a child link of its parent
+		nodePtr& linkTo(nodePtr node)
+		{
+			if (node->parent == endNode())
+				return root;
+			nodePtr parent = nodeOf(node->parent);
+			return (parent->left == node ? parent->left : parent->right);
+		}
+
+		void adoptChildren(nodePtr node)
+		{
+			if (node->left != NULL)
+				node->left->parent = node;
+			if (node->right != NULL)
+				node->right->parent = node;
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,379 @@
+#pragma once
+
+#if __cplusplus < 201103L
+	#error "concurrent_map.hpp requires C++11 (std::atomic and std::mutex)"
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include "map.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	namespace concurrent
+	{
+	/********************	 EPOCHS	 *********************/
+
+		// A reader publishes the global epoch it saw while it is in the
+		// tree, and 0 when it is not. Padded by a cache line on each side
+		// (C++11 new cannot align it): readers never share a line.
+		struct readerSlot
+		{
+			char					before[64];
+			std::atomic<uint64_t>	epoch;
+			std::atomic<bool>		taken;
+			readerSlot*				next;
+			char					after[64];
+
+			readerSlot()
+				: epoch(0), taken(true), next(nullptr) { }
+		};
+
+		// Epoch-based reclamation for one writer. A node taken out of the
+		// tree is retired with the current epoch e, and freed once every
+		// reader in the tree entered after the epoch moved past e: such a
+		// reader read the root after the node was unlinked, so it cannot
+		// reach it. Readers only store to their own slot; the writer bumps
+		// the epoch and scans the slots when it reclaims.
+		class epochDomain
+		{
+		public:
+			epochDomain()
+				: global(1), slots(nullptr) { }
+
+			~epochDomain()
+			{
+				readerSlot* slot = slots.load(std::memory_order_acquire);
+				while (slot)
+				{
+					readerSlot* next = slot->next;
+					delete slot;
+					slot = next;
+				}
+			}
+
+			epochDomain(const epochDomain&) = delete;
+			epochDomain& operator=(const epochDomain&) = delete;
+
+			// a free slot, reused from a reader that went away, or a new one
+			readerSlot* acquire()
+			{
+				for (readerSlot* slot = slots.load(std::memory_order_acquire); slot; slot = slot->next)
+				{
+					bool free = false;
+					if (slot->taken.compare_exchange_strong(free, true, std::memory_order_acquire))
+						return slot;
+				}
+				readerSlot* slot = new readerSlot();
+				slot->next = slots.load(std::memory_order_relaxed);
+				while (!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+					;
+				return slot;
+			}
+
+			void release(readerSlot* slot)
+			{
+				slot->epoch.store(0, std::memory_order_release);
+				slot->taken.store(false, std::memory_order_release);
+			}
+
+			// Seeing an epoch newer than e means seeing what the writer
+			// unlinked before ending e. The fence orders the slot store
+			// before the reader's loads of the tree and pairs with the fence
+			// in safeEpoch: either the writer sees this slot, or this reader
+			// sees the unlinks made before the writer's scan. The slot stores
+			// release what the reader read before, for the writer that frees
+			void enter(readerSlot* slot)
+			{
+				slot->epoch.store(global.load(std::memory_order_acquire), std::memory_order_release);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+
+			void leave(readerSlot* slot)
+			{
+				slot->epoch.store(0, std::memory_order_release);
+			}
+
+			uint64_t current() const
+			{
+				return global.load(std::memory_order_relaxed);
+			}
+
+			// Writer only: ends the current epoch and returns the oldest
+			// epoch a reader may still be in. Nodes retired before it are
+			// unreachable.
+			uint64_t safeEpoch()
+			{
+				global.fetch_add(1, std::memory_order_release);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				uint64_t oldest = std::numeric_limits<uint64_t>::max();
+				for (readerSlot* slot = slots.load(std::memory_order_acquire); slot; slot = slot->next)
+				{
+					uint64_t epoch = slot->epoch.load(std::memory_order_acquire);
+					if (epoch != 0 && epoch < oldest)
+						oldest = epoch;
+				}
+				return oldest;
+			}
+
+		private:
+			std::atomic<uint64_t>		global;
+			std::atomic<readerSlot*>	slots;
+		};
+	}
+
+	// An ordered map for one writer at a time and any number of readers that
+	// never lock: the config table pattern. Readers look up through a
+	// reader handle, one per thread; writers are serialised by a mutex.
+	//
+	//   ft::concurrent_map<int, config> table;
+	//   table.insert_or_assign(ft::make_pair(key, value));	// any thread
+	//   ft::concurrent_map<int, config>::reader r(table);	// per reader thread
+	//   config current;
+	//   if (r.find(key, current)) ...
+	//
+	// It is the tree of ft::map, changed with the published operations of
+	// bst.hpp: a value is never changed in place (insert_or_assign links a
+	// new node), so a reader always sees a whole value. Erased and replaced
+	// nodes are freed by epoch-based reclamation once no reader can be on
+	// them, every reclaim_threshold retirements or on reclaim().
+	//
+	// Lookups are linearisable: a reader sees every change published before
+	// it started and possibly some made while it runs. They are lock-free,
+	// not wait-free: one that misses while an erase moved a key up looks
+	// again (see locate). There are no iterators; a reader handle must not
+	// outlive the map.
+	template<typename Key, typename T, typename Compare = std::less<Key>,
+		typename Alloc = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_map
+	{
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const Key, T>											value_type;
+		typedef Compare															key_compare;
+		typedef size_t															size_type;
+
+	private:
+		typedef typename ft::map<Key, T, Compare, Alloc>::binarySearchTree		tree_type;
+		typedef typename tree_type::nodePtr										nodePtr;
+
+		struct retiredNode
+		{
+			nodePtr		node;
+			uint64_t	epoch;
+		};
+
+	public:
+		static const size_type	reclaim_threshold = 256;
+
+		class reader
+		{
+		public:
+			explicit reader(const concurrent_map& owner)
+				: owner(owner), slot(owner.epochs.acquire()) { }
+
+			~reader()
+			{
+				owner.epochs.release(slot);
+			}
+
+			reader(const reader&) = delete;
+			reader& operator=(const reader&) = delete;
+
+			// copies the value of k into value; false if k is not there
+			bool find(const key_type& k, mapped_type& value) const
+			{
+				return visit(k, [&value](const value_type& entry) { value = entry.second; });
+			}
+
+			bool contains(const key_type& k) const
+			{
+				return visit(k, [](const value_type&) { });
+			}
+
+			// calls function(entry) for the entry of k, if any, while the
+			// entry cannot be freed; the reference must not escape the call
+			template<typename Function>
+			bool visit(const key_type& k, Function function) const
+			{
+				guard inside(*this);
+				nodePtr node = owner.locate(k);
+				if (node == NULL)
+					return false;
+				function(static_cast<const value_type&>(node->data));
+				return true;
+			}
+
+		private:
+			struct guard
+			{
+				explicit guard(const reader& r)
+					: r(r)
+				{
+					r.owner.epochs.enter(r.slot);
+				}
+
+				~guard()
+				{
+					r.owner.epochs.leave(r.slot);
+				}
+
+				const reader&	r;
+			};
+
+			const concurrent_map&		owner;
+			concurrent::readerSlot*		slot;
+		};
+
+		explicit concurrent_map(const key_compare& comp = key_compare(), const Alloc& alloc = Alloc())
+			: tree(comp, typename tree_type::nodeAllocactor(alloc)), count(0), hidden(0) { }
+
+		// no reader may be left
+		~concurrent_map()
+		{
+			for (size_t i = 0; i < retired.size(); i++)
+				tree.freeNode(retired[i].node);
+		}
+
+		concurrent_map(const concurrent_map&) = delete;
+		concurrent_map& operator=(const concurrent_map&) = delete;
+
+	/******************** WRITERS ********************/
+
+		// false if the key was there already; its value is kept
+		bool insert(const value_type& val)
+		{
+			std::lock_guard<std::mutex> hold(writeLock);
+			if (!tree.insertPublished(val).second)
+				return false;
+			count.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// true if the key is new, false if its value was replaced
+		bool insert_or_assign(const value_type& val)
+		{
+			std::lock_guard<std::mutex> hold(writeLock);
+			nodePtr position = tree.findPublished(val.first);
+			if (position == NULL)
+			{
+				tree.insertPublished(val);
+				count.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			makeRoom(1);
+			retire(tree.replacePublished(position, val));
+			return false;
+		}
+
+		size_type erase(const key_type& k)
+		{
+			std::lock_guard<std::mutex> hold(writeLock);
+			nodePtr position = tree.findPublished(k);
+			if (position == NULL)
+				return 0;
+			makeRoom(2);
+			ft::pair<nodePtr, nodePtr> taken = tree.erasePublished(position, [this]() {
+				hidden.fetch_add(1, std::memory_order_release);
+			});
+			count.fetch_sub(1, std::memory_order_relaxed);
+			retire(taken.first);
+			if (taken.second != NULL)
+				retire(taken.second);
+			return 1;
+		}
+
+		// frees the retired nodes no reader can hold any more
+		void reclaim()
+		{
+			std::lock_guard<std::mutex> hold(writeLock);
+			reclaimRetired();
+		}
+
+	/******************** ANY THREAD ********************/
+
+		size_type size() const { return count.load(std::memory_order_relaxed); }
+		bool empty() const { return size() == 0; }
+
+		// nodes waiting for readers to move on
+		size_type retired_count() const
+		{
+			std::lock_guard<std::mutex> hold(writeLock);
+			return retired.size();
+		}
+
+		key_compare key_comp() const { return tree.key_comp(); }
+
+	private:
+		// A two-child erase links a copy of the successor in place of the
+		// erased node, then unlinks the successor from below: a reader that
+		// was already past the erased node misses the key. hidden counts
+		// those unlinks and is bumped before each, so a reader that missed
+		// and sees it moved may have missed through one, and looks again
+		nodePtr locate(const key_type& k) const
+		{
+			uint64_t seen = hidden.load(std::memory_order_acquire);
+			while (true)
+			{
+				nodePtr node = tree.findPublished(k);
+				if (node != NULL)
+					return node;
+				uint64_t now = hidden.load(std::memory_order_acquire);
+				if (now == seen)
+					return NULL;
+				seen = now;
+			}
+		}
+
+		// retiring must not throw once the nodes are out of the tree, so the
+		// room is made before; it grows geometrically, as reserve does not
+		void makeRoom(size_type n)
+		{
+			if (retired.size() + n > retired.capacity())
+				retired.reserve(2 * retired.capacity() + n);
+		}
+
+		void retire(nodePtr node)
+		{
+			retiredNode entry = { node, epochs.current() };
+			retired.push_back(entry);
+			if (retired.size() >= nextReclaim)
+			{
+				reclaimRetired();
+				// what readers still hold is tried again reclaim_threshold
+				// retirements later
+				nextReclaim = retired.size() + reclaim_threshold;
+			}
+		}
+
+		void reclaimRetired()
+		{
+			uint64_t safe = epochs.safeEpoch();
+			size_t kept = 0;
+			for (size_t i = 0; i < retired.size(); i++)
+			{
+				if (retired[i].epoch < safe)
+					tree.freeNode(retired[i].node);
+				else
+					retired[kept++] = retired[i];
+			}
+			while (retired.size() > kept)
+				retired.pop_back();
+		}
+
+		tree_type							tree;
+		std::atomic<size_type>				count;
+		std::atomic<uint64_t>				hidden;				// see locate
+		mutable std::mutex					writeLock;
+		mutable concurrent::epochDomain		epochs;
+		ft::vector<retiredNode>				retired;
+		size_type							nextReclaim = reclaim_threshold;
+	};
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include "vector.hpp"
+
+namespace ft
+{
+	// Copy-on-write wrapper around ft::vector: copies share one reference
+	// counted buffer, the first modifying call on a shared buffer copies it.
+	// Non-const element access and iterators count as modifying calls; use the
+	// const overloads, cbegin()/cend() or read() to look without detaching.
+	//
+	// Handing out a mutable reference or iterator marks the buffer unshareable
+	// (like the old COW std::string): later copies get their own buffer right
+	// away, so writing through the reference never shows in a copy. set()
+	// writes an element without marking the buffer. The mark goes once the
+	// references it guards are invalid anyway: when the buffer reallocates,
+	// and on clear, assign and swap (which invalidates the references and
+	// iterators of both sides, unlike std::vector::swap).
+	template<typename T, typename Allocator = std::allocator<T> >
+	class cow_vector
+	{
+	public:
+		typedef ft::vector<T, Allocator>						vector_type;
+		typedef typename vector_type::value_type				value_type;
+		typedef typename vector_type::reference					reference;
+		typedef typename vector_type::const_reference			const_reference;
+		typedef typename vector_type::pointer					pointer;
+		typedef typename vector_type::const_pointer				const_pointer;
+		typedef typename vector_type::iterator					iterator;
+		typedef typename vector_type::const_iterator			const_iterator;
+		typedef typename vector_type::reverse_iterator			reverse_iterator;
+		typedef typename vector_type::const_reverse_iterator	const_reverse_iterator;
+		typedef typename vector_type::difference_type			difference_type;
+		typedef typename vector_type::size_type					size_type;
+		typedef Allocator										allocator_type;
+
+	private:
+		struct sharedBuffer
+		{
+			vector_type	data;
+			long		refs;
+			bool		unshareable;
+
+			explicit sharedBuffer(const vector_type& data)
+				: data(data), refs(1), unshareable(false) { }
+		};
+
+		typedef typename Allocator::template rebind<sharedBuffer>::other	bufferAllocator;
+
+		sharedBuffer*	buffer;
+
+	public:
+		explicit cow_vector(const Allocator& alloc = Allocator())
+			: buffer(newBuffer(vector_type(alloc))) { }
+
+		explicit cow_vector(size_type n, const value_type& val = value_type(), const Allocator& alloc = Allocator())
+			: buffer(newBuffer(vector_type(n, val, alloc))) { }
+
+		template<typename InputIterator>
+		cow_vector(InputIterator first, InputIterator last, const Allocator& alloc = Allocator(), typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+			: buffer(newBuffer(vector_type(first, last, alloc))) { }
+
+		explicit cow_vector(const vector_type& x)
+			: buffer(newBuffer(x)) { }
+
+		cow_vector(const cow_vector& x)
+			: buffer(x.share()) { }
+
+		~cow_vector()
+		{
+			release(buffer);
+		}
+
+		cow_vector& operator=(const cow_vector& rhs)
+		{
+			sharedBuffer* shared = rhs.share();
+			release(buffer);
+			buffer = shared;
+			return *this;
+		}
+
+	// SHARING //
+
+		size_type use_count() const
+		{
+			return __atomic_load_n(&buffer->refs, __ATOMIC_ACQUIRE);
+		}
+
+		const vector_type& read() const
+		{
+			return buffer->data;
+		}
+
+	// CAPACITY //
+
+		size_type size() const { return buffer->data.size(); }
+		size_type max_size() const { return buffer->data.max_size(); }
+		bool empty() const { return buffer->data.empty(); }
+		size_type capacity() const { return buffer->data.capacity(); }
+
+		void resize(size_type n, value_type val = value_type())
+		{
+			size_type room = capacity();
+			mutate().resize(n, val);
+			reshareIfMoved(room);
+		}
+
+		void reserve(size_type n)
+		{
+			if (n <= capacity())
+				return;
+			mutate().reserve(n);
+			buffer->unshareable = false;
+		}
+
+	// ITERATORS //
+
+		iterator begin() { return leak().begin(); }
+		const_iterator begin() const { return buffer->data.begin(); }
+		iterator end() { return leak().end(); }
+		const_iterator end() const { return buffer->data.end(); }
+		reverse_iterator rbegin() { return leak().rbegin(); }
+		const_reverse_iterator rbegin() const { return buffer->data.rbegin(); }
+		reverse_iterator rend() { return leak().rend(); }
+		const_reverse_iterator rend() const { return buffer->data.rend(); }
+		const_iterator cbegin() const { return buffer->data.begin(); }
+		const_iterator cend() const { return buffer->data.end(); }
+
+	// ELEMENT ACCESS //
+
+		reference operator[](size_type idx) { return leak()[idx]; }
+		const_reference operator[](size_type idx) const { return buffer->data[idx]; }
+		reference at(size_type n) { return leak().at(n); }
+		const_reference at(size_type n) const { return buffer->data.at(n); }
+		reference front() { return leak().front(); }
+		const_reference front() const { return buffer->data.front(); }
+		reference back() { return leak().back(); }
+		const_reference back() const { return buffer->data.back(); }
+
+	// MODIFIERS //
+
+		void set(size_type idx, const value_type& val)
+		{
+			mutate()[idx] = val;
+		}
+
+		template<typename InputIterator>
+		void assign(InputIterator first, InputIterator last, typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+		{
+			cow_vector temp(first, last, get_allocator());
+			swap(temp);
+		}
+
+		void assign(size_type n, const value_type& val)
+		{
+			cow_vector temp(n, val, get_allocator());
+			swap(temp);
+		}
+
+		void push_back(const value_type& val)
+		{
+			size_type room = capacity();
+			mutate().push_back(val);
+			reshareIfMoved(room);
+		}
+
+		void pop_back()
+		{
+			mutate().pop_back();
+		}
+
+		// positions may point into the shared buffer: they are turned into
+		// indexes before the buffer is detached
+		iterator insert(iterator position, const value_type& val)
+		{
+			difference_type idx = position - buffer->data.begin();
+			vector_type& data = leak();
+			return data.insert(data.begin() + idx, val);
+		}
+
+		void insert(iterator position, size_type n, const value_type& val)
+		{
+			difference_type idx = position - buffer->data.begin();
+			size_type room = capacity();
+			vector_type& data = mutate();
+			data.insert(data.begin() + idx, n, val);
+			reshareIfMoved(room);
+		}
+
+		template<typename InputIterator>
+		void insert(iterator position, InputIterator first, InputIterator last, typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = 0)
+		{
+			difference_type idx = position - buffer->data.begin();
+			size_type room = capacity();
+			vector_type& data = mutate();
+			data.insert(data.begin() + idx, first, last);
+			reshareIfMoved(room);
+		}
+
+		iterator erase(iterator position)
+		{
+			difference_type idx = position - buffer->data.begin();
+			vector_type& data = leak();
+			return data.erase(data.begin() + idx);
+		}
+
+		iterator erase(iterator first, iterator last)
+		{
+			difference_type idx = first - buffer->data.begin();
+			difference_type count = last - first;
+			vector_type& data = leak();
+			return data.erase(data.begin() + idx, data.begin() + idx + count);
+		}
+
+		void clear()
+		{
+			if (use_count() > 1)
+			{
+				cow_vector temp(get_allocator());
+				swap(temp);
+			}
+			else
+			{
+				mutate().clear();
+				buffer->unshareable = false;
+			}
+		}
+
+		void swap(cow_vector& x) throw()
+		{
+			std::swap(buffer, x.buffer);
+			buffer->unshareable = false;
+			x.buffer->unshareable = false;
+		}
+
+		allocator_type get_allocator() const
+		{
+			return buffer->data.get_allocator();
+		}
+
+	private:
+		static sharedBuffer* newBuffer(const vector_type& data)
+		{
+			bufferAllocator alloc;
+			sharedBuffer* shared = alloc.allocate(1);
+			try
+			{
+				::new (static_cast<void*>(shared)) sharedBuffer(data);
+			}
+			catch (...)
+			{
+				alloc.deallocate(shared, 1);
+				throw;
+			}
+			return shared;
+		}
+
+		static void release(sharedBuffer* shared)
+		{
+			if (__atomic_sub_fetch(&shared->refs, 1, __ATOMIC_ACQ_REL) == 0)
+			{
+				bufferAllocator alloc;
+				shared->~sharedBuffer();
+				alloc.deallocate(shared, 1);
+			}
+		}
+
+		// an unshareable buffer is copied at once: someone may still write
+		// through a reference into it
+		sharedBuffer* share() const
+		{
+			if (buffer->unshareable)
+				return newBuffer(buffer->data);
+			__atomic_add_fetch(&buffer->refs, 1, __ATOMIC_RELAXED);
+			return buffer;
+		}
+
+		// gives this object its own buffer before a modification
+		vector_type& mutate()
+		{
+			if (use_count() > 1)
+			{
+				sharedBuffer* own = newBuffer(buffer->data);
+				release(buffer);
+				buffer = own;
+			}
+			return buffer->data;
+		}
+
+		// mutate() for calls that hand out a mutable reference or iterator
+		vector_type& leak()
+		{
+			vector_type& data = mutate();
+			buffer->unshareable = true;
+			return data;
+		}
+
+		// a modification that reallocated left nothing the mark guards
+		void reshareIfMoved(size_type capacityBefore)
+		{
+			if (capacity() != capacityBefore)
+				buffer->unshareable = false;
+		}
+	};
+
+	template<typename T, typename Allocator>
+	inline bool operator==(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return lhs.read() == rhs.read();
+	}
+
+	template<typename T, typename Allocator>
+	inline bool operator!=(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template<typename T, typename Allocator>
+	inline bool operator<(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return lhs.read() < rhs.read();
+	}
+
+	template<typename T, typename Allocator>
+	inline bool operator>(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template<typename T, typename Allocator>
+	inline bool operator<=(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template<typename T, typename Allocator>
+	inline bool operator>=(const cow_vector<T, Allocator>& lhs, const cow_vector<T, Allocator>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+}
+
+namespace std
+{
+	template<class T, class Alloc>
+	inline void swap(ft::cow_vector<T, Alloc>& a, ft::cow_vector<T, Alloc>& b)
+	{
+		a.swap(b);
+	}
+}
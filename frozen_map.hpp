@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// Read-only snapshot of a sorted, duplicate-free range, built by
+	// ft::map::freeze. The keys are stored in Eytzinger (breadth-first)
+	// order: the children of slot i are slots 2i and 2i + 1, so the top
+	// levels of every search share the same few cache lines, and the
+	// descent needs no pointers and no branch on the comparison. The
+	// entries sit in a parallel array in the same order; iteration walks
+	// the implicit tree in order.
+	template<typename Key, typename T, typename Compare = std::less<Key> >
+	class frozen_map
+	{
+	public:
+		typedef Key									key_type;
+		typedef T									mapped_type;
+		typedef ft::pair<const Key, T>				value_type;
+		typedef Compare								key_compare;
+		typedef size_t								size_type;
+		typedef ptrdiff_t							difference_type;
+		typedef const value_type&					reference;
+		typedef const value_type&					const_reference;
+		typedef const value_type*					pointer;
+		typedef const value_type*					const_pointer;
+
+		class const_iterator
+			: public ft::iterator<std::bidirectional_iterator_tag, const value_type>
+		{
+		public:
+			const_iterator()
+				: owner(NULL), slot(0) { }
+
+			const_reference operator*() const { return owner->entries[slot - 1]; }
+			const_pointer operator->() const { return &owner->entries[slot - 1]; }
+
+			const_iterator& operator++()
+			{
+				slot = owner->nextSlot(slot);
+				return *this;
+			}
+
+			const_iterator operator++(int)
+			{
+				const_iterator old(*this);
+				++*this;
+				return old;
+			}
+
+			const_iterator& operator--()
+			{
+				slot = owner->prevSlot(slot);
+				return *this;
+			}
+
+			const_iterator operator--(int)
+			{
+				const_iterator old(*this);
+				--*this;
+				return old;
+			}
+
+			bool operator==(const const_iterator& rhs) const { return slot == rhs.slot; }
+			bool operator!=(const const_iterator& rhs) const { return slot != rhs.slot; }
+
+		private:
+			friend class frozen_map;
+
+			const_iterator(const frozen_map* owner, size_type slot)
+				: owner(owner), slot(slot) { }
+
+			const frozen_map*	owner;
+			size_type			slot;
+		};
+
+		typedef const_iterator						iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef const_reverse_iterator				reverse_iterator;
+
+	private:
+		friend class const_iterator;
+
+		// keys[0] is padding, the tree starts at slot 1; entries[i - 1]
+		// belongs to keys[i]
+		ft::vector<key_type>	keys;
+		ft::vector<value_type>	entries;
+		key_compare				comp;
+
+	public:
+		explicit frozen_map(const key_compare& comp = key_compare())
+			: comp(comp) { }
+
+		// [first, last) must be sorted by comp without equal keys, as a
+		// map's range is; count is its length
+		template<typename ForwardIterator>
+		frozen_map(ForwardIterator first, ForwardIterator last, size_type count,
+			const key_compare& comp = key_compare())
+			: comp(comp)
+		{
+			if (count == 0)
+				return;
+			ft::vector<ForwardIterator> sorted;
+			sorted.reserve(count);
+			for (; first != last; ++first)
+				sorted.push_back(first);
+			// in-order walk of the implicit tree: slot -> rank in the range
+			ft::vector<size_type> rankAt(count + 1);
+			size_type slot = firstSlot(count);
+			for (size_type rank = 0; rank < count; ++rank, slot = nextSlot(slot, count))
+				rankAt[slot] = rank;
+			keys.reserve(count + 1);
+			entries.reserve(count);
+			keys.push_back(sorted[0]->first);
+			for (slot = 1; slot <= count; ++slot)
+			{
+				keys.push_back(sorted[rankAt[slot]]->first);
+				entries.push_back(*sorted[rankAt[slot]]);
+			}
+		}
+
+	/******************** ITERATORS ********************/
+
+		const_iterator begin() const { return const_iterator(this, firstSlot(size())); }
+		const_iterator end() const { return const_iterator(this, 0); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	/******************** CAPACITY ********************/
+
+		bool empty() const { return entries.empty(); }
+		size_type size() const { return entries.size(); }
+
+	/******************** LOOKUP ********************/
+
+		const mapped_type& at(const key_type& k) const
+		{
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("frozen_map out of range");
+			return it->second;
+		}
+
+		const_iterator find(const key_type& k) const
+		{
+			size_type slot = lowerBoundSlot(k);
+			if (slot == 0 || comp(k, keys[slot]))
+				return end();
+			return const_iterator(this, slot);
+		}
+
+		size_type count(const key_type& k) const
+		{
+			return find(k) != end();
+		}
+
+		const_iterator lower_bound(const key_type& k) const
+		{
+			return const_iterator(this, lowerBoundSlot(k));
+		}
+
+		const_iterator upper_bound(const key_type& k) const
+		{
+			const key_type* tree = keys.data();
+			size_type n = size();
+			size_type slot = 1;
+			while (slot <= n)
+			{
+				__builtin_prefetch(tree + slot * prefetchStride);
+				slot = 2 * slot + !comp(k, tree[slot]);
+			}
+			return const_iterator(this, slot >> __builtin_ffsl(~slot));
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type& k) const
+		{
+			return ft::make_pair(lower_bound(k), upper_bound(k));
+		}
+
+		key_compare key_comp() const { return comp; }
+
+	/******************** MODIFIERS ********************/
+
+		void swap(frozen_map& other)
+		{
+			keys.swap(other.keys);
+			entries.swap(other.entries);
+			std::swap(comp, other.comp);
+		}
+
+	private:
+		// the descendants of slot i that are log2(stride) levels down are
+		// contiguous from slot i * stride: prefetching them while the
+		// current comparison runs hides the misses of the next levels
+		static const size_type prefetchStride = sizeof(key_type) <= 4 ? 16
+			: sizeof(key_type) <= 8 ? 8
+			: sizeof(key_type) <= 16 ? 4 : 2;
+
+		// goes right on every key less than k, then climbs back past the
+		// trailing right turns: the last left turn is the lower bound
+		size_type lowerBoundSlot(const key_type& k) const
+		{
+			const key_type* tree = keys.data();
+			size_type n = size();
+			size_type slot = 1;
+			while (slot <= n)
+			{
+				__builtin_prefetch(tree + slot * prefetchStride);
+				slot = 2 * slot + comp(tree[slot], k);
+			}
+			return slot >> __builtin_ffsl(~slot);
+		}
+
+		size_type nextSlot(size_type slot) const { return nextSlot(slot, size()); }
+		size_type prevSlot(size_type slot) const { return prevSlot(slot, size()); }
+
+		static size_type firstSlot(size_type n)
+		{
+			if (n == 0)
+				return 0;
+			size_type slot = 1;
+			while (2 * slot <= n)
+				slot *= 2;
+			return slot;
+		}
+
+		// in-order successor, 0 past the last slot
+		static size_type nextSlot(size_type slot, size_type n)
+		{
+			if (2 * slot + 1 <= n)
+			{
+				slot = 2 * slot + 1;
+				while (2 * slot <= n)
+					slot *= 2;
+				return slot;
+			}
+			while (slot & 1)
+				slot >>= 1;
+			return slot >> 1;
+		}
+
+		// in-order predecessor, and the last slot from 0
+		static size_type prevSlot(size_type slot, size_type n)
+		{
+			if (slot == 0)
+				slot = 1;
+			else if (2 * slot <= n)
+				slot = 2 * slot;
+			else
+			{
+				while (slot > 1 && !(slot & 1))
+					slot >>= 1;
+				return slot >> 1;
+			}
+			while (2 * slot + 1 <= n)
+				slot = 2 * slot + 1;
+			return slot;
+		}
+	};
+
+	template<typename Key, typename T, typename Compare>
+	void swap(frozen_map<Key, T, Compare>& lhs, frozen_map<Key, T, Compare>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
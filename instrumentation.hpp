@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// -D FT_INSTRUMENTATION=1 makes the containers count their events (see
+// ft::instrumentation below); by default every hook compiles to nothing
+#ifndef FT_INSTRUMENTATION
+	#define FT_INSTRUMENTATION 0
+#endif
+
+namespace ft
+{
+	struct events
+	{
+		// who counted the event: ft::vector (and its iterators), or the
+		// tree under ft::map
+		enum container
+		{
+			VECTOR,
+			TREE,
+			CONTAINER_COUNT
+		};
+
+		enum kind
+		{
+			ALLOCATIONS,		// buffers for a vector, nodes for a tree
+			REALLOCATIONS,		// a vector moving to a larger buffer
+			BYTES_COPIED,		// element bytes a reallocation copied
+			LOOKUPS,			// find, lower_bound and upper_bound calls
+			COMPARISONS,		// every call of the tree's comparator
+			NODES_VISITED,		// tree nodes a lookup went through
+			ITERATOR_STEPS,		// ++ and -- on the container's iterators
+			KIND_COUNT
+		};
+
+		static const char* containerName(container where)
+		{
+			static const char* names[] = { "vector", "tree" };
+
+			return names[where];
+		}
+
+		static const char* kindName(kind what)
+		{
+			static const char* names[] = { "allocations", "reallocations", "bytes_copied", "lookups",
+				"comparisons", "nodes_visited", "iterator_steps" };
+
+			return names[what];
+		}
+	};
+
+	// counter values at one point in time; subtract two snapshots to get
+	// the events of the code between them
+	struct instrumentationSnapshot
+	{
+		unsigned long long	value[events::CONTAINER_COUNT][events::KIND_COUNT];
+
+		instrumentationSnapshot()
+		{
+			for (int c = 0; c < events::CONTAINER_COUNT; c++)
+				for (int k = 0; k < events::KIND_COUNT; k++)
+					value[c][k] = 0;
+		}
+
+		unsigned long long operator()(events::container where, events::kind what) const
+		{
+			return value[where][what];
+		}
+
+		instrumentationSnapshot operator-(const instrumentationSnapshot& rhs) const
+		{
+			instrumentationSnapshot diff;
+			for (int c = 0; c < events::CONTAINER_COUNT; c++)
+				for (int k = 0; k < events::KIND_COUNT; k++)
+					diff.value[c][k] = value[c][k] - rhs.value[c][k];
+			return diff;
+		}
+	};
+
+	// the default policy: nothing is counted and every snapshot is zero
+	struct noInstrumentation
+	{
+		static const bool	enabled = false;
+
+		static void record(events::container, events::kind, unsigned long long = 1) { }
+
+		static instrumentationSnapshot snapshot()
+		{
+			return instrumentationSnapshot();
+		}
+	};
+
+	// Every thread counts into its own block, so recording is a plain
+	// add without contention. The blocks are chained in a list that
+	// snapshot() sums; a block outlives its thread, so the events of
+	// finished threads stay in the totals.
+	struct countingInstrumentation
+	{
+		struct counters
+		{
+			unsigned long long	value[events::CONTAINER_COUNT][events::KIND_COUNT];
+			counters*			next;
+		};
+
+		static const bool	enabled = true;
+
+		static void record(events::container where, events::kind what, unsigned long long n = 1)
+		{
+			counters* block = local();
+			if (!block)
+				return;
+			unsigned long long* counter = &block->value[where][what];
+			// only the owning thread writes: relaxed accesses are enough to
+			// let snapshot() read while the owner counts
+			__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+		}
+
+		static instrumentationSnapshot snapshot()
+		{
+			instrumentationSnapshot total;
+			for (counters* block = __atomic_load_n(&head(), __ATOMIC_ACQUIRE); block; block = block->next)
+				for (int c = 0; c < events::CONTAINER_COUNT; c++)
+					for (int k = 0; k < events::KIND_COUNT; k++)
+						total.value[c][k] += __atomic_load_n(&block->value[c][k], __ATOMIC_RELAXED);
+			return total;
+		}
+
+	private:
+		static counters*& head()
+		{
+			static counters*	blocks = NULL;
+
+			return blocks;
+		}
+
+		// NULL if the thread's block could not be allocated: recording must
+		// not throw out of the throw() members it is called from
+		static counters* local()
+		{
+			static __thread counters*	block = NULL;
+
+			if (!block)
+			{
+				block = new (std::nothrow) counters();
+				if (!block)
+					return NULL;
+				block->next = __atomic_load_n(&head(), __ATOMIC_RELAXED);
+				while (!__atomic_compare_exchange_n(&head(), &block->next, block, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+					;
+			}
+			return block;
+		}
+	};
+
+	// the policy the containers are built with
+#if FT_INSTRUMENTATION
+	typedef countingInstrumentation	instrumentation;
+#else
+	typedef noInstrumentation		instrumentation;
+#endif
+}
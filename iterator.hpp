@@ -2,9 +2,7 @@
 
 #include <cstddef>
 #include "utils.hpp"
-#include <iostream>
-
-#define ITERATOR_COMMENTS 0
+#include "instrumentation.hpp"
 
 namespace ft
 {
@@ -51,17 +49,16 @@ namespace ft
 	template<typename Iterator>
 	inline typename ft::iterator_traits<Iterator>::iterator_category iterator_category(const Iterator&)
 	{
-		if (ITERATOR_COMMENTS)
-			std::cout << "iterator_category() function called" << std::endl;
 		return (typename ft::iterator_traits<Iterator>::iterator_category());
 	}
 
 	/********************	 ITERATOR BASE FUNCTIONS	 *********************/
 
-	template<typename ForwardIterator>
-	inline typename ft::iterator_traits<ForwardIterator>::difference_type iteratorDistance(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+	// input iterators are single pass: counting consumes the range
+	template<typename InputIterator>
+	inline typename ft::iterator_traits<InputIterator>::difference_type iteratorDistance(InputIterator first, InputIterator last, std::input_iterator_tag)
 	{
-		typename ft::iterator_traits<ForwardIterator>::difference_type n = 0;
+		typename ft::iterator_traits<InputIterator>::difference_type n = 0;
 		while (first != last)
 		{
 			++first;
@@ -106,15 +103,11 @@ namespace ft
 		vectorIterator() throw()
 			: current(Iterator()) 
 		{
-			if (ITERATOR_COMMENTS)
-				std::cout << "vectorIterator default constructor called" << std::endl;
 		}
 
 		explicit vectorIterator(const Iterator& iter) throw()
 			: current(iter)
 		{
-			if (ITERATOR_COMMENTS)
-				std::cout << "vectorIterator parameter constructor called" << std::endl;
 		}
 
 		// Allow iterator to const_iterator conversion
@@ -122,8 +115,6 @@ namespace ft
 		vectorIterator(const vectorIterator<Iter>& iter) throw()
 			: current(iter.base())
 		{
-			if (ITERATOR_COMMENTS)
-				std::cout << "vectorIterator parameter constructor (to const) called" << std::endl;
 		}
 
 		const Iterator& base() const throw()
@@ -144,24 +135,28 @@ namespace ft
 
 		vectorIterator& operator++() throw()
 		{
+			instrumentation::record(events::VECTOR, events::ITERATOR_STEPS);
 			++current;
 			return *this;
 		}
 
 		vectorIterator operator++(int) throw()
 		{
+			instrumentation::record(events::VECTOR, events::ITERATOR_STEPS);
 			return vectorIterator(current++);
 		}
 
 		// Bidirectional iterator requirements
 		vectorIterator& operator--() throw()
 		{
+			instrumentation::record(events::VECTOR, events::ITERATOR_STEPS);
 			--current;
 			return *this;
 		}
 
 		vectorIterator operator--(int) throw()
 		{
+			instrumentation::record(events::VECTOR, events::ITERATOR_STEPS);
 			return vectorIterator(current--);
 		}
 
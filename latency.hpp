@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <time.h>
+#if defined(__x86_64__)
+	#include <x86intrin.h>
+#endif
+
+// Per-call latency measurement: tickClock reads timestamps cheap enough to
+// take around every single call, latencyHistogram keeps their distribution
+// for the tail percentiles.
+//
+//   ft::latencyHistogram histogram;
+//   for (...)
+//       ft::timed(histogram, operation);
+//   histogram.percentile(99.9) / ft::tickClock::ticksPerNs()
+
+namespace ft
+{
+	// The TSC where there is one, as a clock_gettime per call costs more
+	// than most of the calls; CLOCK_MONOTONIC nanoseconds elsewhere. The
+	// reads are fenced so that the timed code cannot move across them:
+	// start() waits for the code before it and holds back the code after,
+	// stop() (rdtscp) waits for the timed code and holds back what follows.
+	class tickClock
+	{
+	public:
+		static unsigned long long start()
+		{
+#if defined(__x86_64__)
+			_mm_lfence();
+			unsigned long long ticks = __rdtsc();
+			_mm_lfence();
+			return ticks;
+#else
+			return static_cast<unsigned long long>(nowNs());
+#endif
+		}
+
+		static unsigned long long stop()
+		{
+#if defined(__x86_64__)
+			unsigned int processor;
+			unsigned long long ticks = __rdtscp(&processor);
+			_mm_lfence();
+			return ticks;
+#else
+			return static_cast<unsigned long long>(nowNs());
+#endif
+		}
+
+		static double ticksPerNs()
+		{
+			static double	rate = calibrate();
+
+			return rate;
+		}
+
+		// the smallest reading of a start() right before a stop(), taken off
+		// every sample so that an empty call reads about 0
+		static unsigned long long overhead()
+		{
+			static unsigned long long	ticks = measureOverhead();
+
+			return ticks;
+		}
+
+	private:
+		static double nowNs()
+		{
+			struct timespec	ts;
+
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return ts.tv_sec * 1e9 + ts.tv_nsec;
+		}
+
+		static double calibrate()
+		{
+			double startNs = nowNs();
+			unsigned long long begin = start();
+			while (nowNs() - startNs < 20e6)
+				;
+			return (stop() - begin) / (nowNs() - startNs);
+		}
+
+		static unsigned long long measureOverhead()
+		{
+			unsigned long long best = ~0ULL;
+			for (int i = 0; i < 1000; i++)
+			{
+				unsigned long long begin = start();
+				best = std::min(best, stop() - begin);
+			}
+			return best;
+		}
+	};
+
+	// HDR-style histogram: values below 2^SUB_BITS get a bucket each, every
+	// larger power of two is cut into 2^(SUB_BITS - 1) buckets, so a recorded
+	// value is known to within 1 / 2^(SUB_BITS - 1) (about 3%) whatever its
+	// size, in a fixed 15 KiB. Percentiles report the top of their bucket.
+	class latencyHistogram
+	{
+	public:
+		latencyHistogram()
+		{
+			clear();
+		}
+
+		void record(unsigned long long value)
+		{
+			++counts[bucket(value)];
+			++total;
+			highest = std::max(highest, value);
+		}
+
+		void clear()
+		{
+			std::fill(counts, counts + BUCKETS, 0ULL);
+			total = 0;
+			highest = 0;
+		}
+
+		unsigned long long count() const
+		{
+			return total;
+		}
+
+		unsigned long long max() const
+		{
+			return highest;
+		}
+
+		// the smallest value that at least percent % of the samples do not exceed
+		unsigned long long percentile(double percent) const
+		{
+			unsigned long long rank = static_cast<unsigned long long>(std::ceil(percent / 100 * total));
+			unsigned long long seen = 0;
+			for (int i = 0; i < BUCKETS; i++)
+			{
+				seen += counts[i];
+				if (seen >= rank && seen != 0)
+					return std::min(bucketTop(i), highest);
+			}
+			return highest;
+		}
+
+	private:
+		enum
+		{
+			SUB_BITS = 6,
+			HALF = 1 << (SUB_BITS - 1),
+			BUCKETS = (64 - SUB_BITS + 2) * HALF
+		};
+
+		static int bucket(unsigned long long value)
+		{
+			if (value < 2 * HALF)
+				return static_cast<int>(value);
+			int magnitude = 63 - __builtin_clzll(value);
+			int shift = magnitude - SUB_BITS + 1;
+			return (shift + 1) * HALF + static_cast<int>(value >> shift) - HALF;
+		}
+
+		static unsigned long long bucketTop(int i)
+		{
+			if (i < 2 * HALF)
+				return i;
+			int shift = i / HALF - 1;
+			unsigned long long sub = i % HALF + HALF;
+			return ((sub + 1) << shift) - 1;
+		}
+
+		unsigned long long	counts[BUCKETS];
+		unsigned long long	total;
+		unsigned long long	highest;
+	};
+
+	// times one call of operation() into the histogram, in ticks
+	template<typename Operation>
+	inline void timed(latencyHistogram& histogram, Operation operation)
+	{
+		unsigned long long begin = tickClock::start();
+		operation();
+		unsigned long long ticks = tickClock::stop() - begin;
+		histogram.record(ticks > tickClock::overhead() ? ticks - tickClock::overhead() : 0);
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bst.hpp"
+#include "frozen_map.hpp"
 #include <functional>
 #include <exception>
 #include <stdexcept>
@@ -8,6 +9,14 @@
 namespace ft
 {
 
+// bulk set algebra (map_algebra.hpp) works on the nodes directly
+template<typename Map>
+struct mapAlgebra;
+
+// binary snapshots (snapshot.hpp) load straight into the tree
+template<typename Map>
+struct mapSnapshot;
+
 template <class Key, class T, class Compare = std::less<Key> , class Alloc = std::allocator<pair<const Key,T> > >
 class map
 {
@@ -28,25 +37,38 @@ public:
 	typedef ft::bst<key_type, mapped_type, value_type, key_compare, allocator_type>		binarySearchTree;
 	typedef typename binarySearchTree::nodePtr											nodePtr;
 	typedef typename binarySearchTree::constNodePtr										constNodePtr;
-	typedef typename ft::bstIterator<nodePtr, value_type>								iterator;
-	typedef typename ft::bstIterator<constNodePtr, const_value_type>					const_iterator;
+	typedef typename binarySearchTree::linkPtr											linkPtr;
+	typedef typename binarySearchTree::constLinkPtr										constLinkPtr;
+	typedef typename ft::bstIterator<linkPtr, value_type>								iterator;
+	typedef typename ft::bstIterator<constLinkPtr, const_value_type>					const_iterator;
 	typedef ft::reverse_iterator<iterator>												reverse_iterator;
 	typedef ft::reverse_iterator<const_iterator>										const_reverse_iterator;
+	typedef ft::nodeHandle<value_type, allocator_type>									node_type;
+
+	struct insert_return_type
+	{
+		iterator	position;
+		bool		inserted;
+		node_type	node;
+	};
 	
 private:
+	// holds the comparator and the allocator too
 	binarySearchTree																	bst;
-	Compare																				compare;
-	allocator_type																		allocator;
 
 
 public:
 
+	// the binary_function typedefs, spelled out: the base is deprecated since C++11
 	class value_compare
-		: std::binary_function<value_type, value_type, bool>
 	{
 		public:
 			friend class map;
 
+			typedef value_type	first_argument_type;
+			typedef value_type	second_argument_type;
+			typedef bool		result_type;
+
 			bool operator() (const value_type& lhs, const value_type& rhs) const
 			{
 				return (comp(lhs.first, rhs.first));
@@ -60,30 +82,31 @@ public:
 	};
 
 	explicit map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-		: bst(binarySearchTree()), compare(comp), allocator(alloc) { }
+		: bst(comp, alloc) { }
 
 	template<typename InputIterator>
 	map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-		: bst(binarySearchTree()), compare(comp), allocator(alloc)
+		: bst(comp, alloc)
 	{
 		InputIterator temp = first;
 		for(;temp != last; ++temp)
-			bst.insert(bst.root, *temp, bst.root->parent);
+			bst.insert(bst.root, *temp, bst.endNode());
 	}
 
 	map (const map& x)
-		:bst(binarySearchTree()), compare(x.compare), allocator(x.allocator)
+		:bst(x.key_comp(), x.get_allocator())
 	{
-		bst.copyTree(x.bst.root, this->bst.root, x.bst.nil);
+		bst.copyTree(x.bst.root);
 	}
 
 	~map() { }
 
 	map&	operator= (const map& rhs) {
+		if (this == &rhs)
+			return *this;
 		this->clear();
-		bst.copyTree(rhs.bst.root, this->bst.root, rhs.bst.nil);
-		compare	= rhs.compare;
-		allocator	= rhs.allocator;
+		bst.assignPolicies(rhs.bst);
+		bst.copyTree(rhs.bst.root);
 		return *this;
 	}
 
@@ -96,9 +119,15 @@ public:
 	{
 		return bst.size();
 	}
+	// shape and memory of the tree in one O(n) walk: see map_stats in bst.hpp
+	map_stats stats() const
+	{
+		return bst.shapeStats();
+	}
+
 	size_type max_size() const
 	{
-		return allocator.max_size();
+		return get_allocator().max_size();
 	}
 
 	mapped_type& operator[] (const key_type& k)
@@ -117,7 +146,7 @@ public:
 	ft::pair<iterator, bool> insert (const value_type& val)
 	{
 		size_t prevTreeSize = bst.getTreeSize();
-		iterator it = iterator(bst.insert(bst.root, val, bst.root->parent));
+		iterator it = iterator(bst.insert(bst.root, val, bst.endNode()));
 		if (bst.getTreeSize() == prevTreeSize)
 			return (ft::make_pair<iterator, bool>(it, false));
 		else
@@ -127,7 +156,7 @@ public:
 	iterator insert (iterator position, const value_type& val)
 	{
 		(void)position;
-		return iterator(bst.insert(bst.root, val, bst.root->parent));
+		return iterator(bst.insert(bst.root, val, bst.endNode()));
 	}
 
 	template <class InputIterator>
@@ -154,15 +183,73 @@ public:
 		else return 0;
 	}
 	
+	// NODE HANDLES //
+
+	// unlinks the element at position; it can be inserted into another map
+	// without reallocation, or is freed with the handle
+	node_type extract(iterator position)
+	{
+		return node_type(bst.extractNode(position.bstNode), get_allocator());
+	}
+
+	node_type extract(const key_type& k)
+	{
+		iterator position = find(k);
+		if (position == end())
+			return node_type();
+		return extract(position);
+	}
+
+	// takes the handle by value: the node is handed over on the call, so both
+	// m.insert(other.extract(k)) and m.insert(handle) work in C++98. When the
+	// key is already present the node comes back in the result
+	insert_return_type insert(node_type nh)
+	{
+		insert_return_type result;
+		result.position = end();
+		result.inserted = false;
+		if (nh.empty())
+			return result;
+		ft::pair<nodePtr, bool> linked = bst.insertNode(nh.get());
+		result.position = iterator(linked.first);
+		result.inserted = linked.second;
+		if (linked.second)
+			nh.release();
+		else
+			result.node = nh;
+		return result;
+	}
+
+	// moves the elements of source whose keys are not in this map yet,
+	// without allocating: the nodes are relinked
+	void merge(map& source)
+	{
+		bst.merge(source.bst);
+	}
+
+	// the range is split off the tree and released in one pass: O(height + k)
 	void erase (iterator first, iterator last)
 	{
-		iterator toDelete;
-		while (first != last)
-		{
-			toDelete = first;
-			first++;
-			bst.erase(toDelete.bstNode);
-		}
+		bst.eraseRange(first.bstNode, last.bstNode);
+	}
+
+	// moves the elements with keys in [lo, hi) into a new map without copying
+	// or reallocating them; iterators to the moved elements now belong to it
+	map extract_range(const key_type& lo, const key_type& hi)
+	{
+		map extracted(key_comp(), get_allocator());
+		extract_range(lo, hi, extracted);
+		return extracted;
+	}
+
+	// the same into an existing map, whose elements are replaced: assigning
+	// the result of the form above would copy every element over again
+	void extract_range(const key_type& lo, const key_type& hi, map& into)
+	{
+		map extracted(key_comp(), get_allocator());
+		if (key_comp()(lo, hi))
+			bst.extractRange(lower_bound(lo).bstNode, lower_bound(hi).bstNode, extracted.bst);
+		into.swap(extracted);
 	}
 
 	iterator find(const key_type& k)
@@ -200,6 +287,64 @@ public:
 		return(bst.upper_bound(bst.root, k));
 	}
 
+	// number of keys less than k, O(height)
+	size_type rank(const key_type& k) const
+	{
+		return bst.rank(k);
+	}
+
+	// i-th smallest element, end() when i >= size(), O(height)
+	iterator select(size_type i)
+	{
+		return iterator(bst.select(i));
+	}
+
+	const_iterator select(size_type i) const
+	{
+		return const_iterator(bst.select(i));
+	}
+
+	// batched lookups for keys in ascending order: one iterator per key goes
+	// to out (end() when missing). Every search starts at the previous result
+	// and climbs only as far as needed, so a dense batch of k keys costs
+	// O(k log(n/k)) instead of O(k log n)
+	template<typename ForwardIterator, typename OutputIterator>
+	OutputIterator find_sorted(ForwardIterator keyFirst, ForwardIterator keyLast, OutputIterator out)
+	{
+		return bst.template sortedSearch<iterator>(keyFirst, keyLast, out, true);
+	}
+
+	template<typename ForwardIterator, typename OutputIterator>
+	OutputIterator find_sorted(ForwardIterator keyFirst, ForwardIterator keyLast, OutputIterator out) const
+	{
+		return bst.template sortedSearch<const_iterator>(keyFirst, keyLast, out, true);
+	}
+
+	template<typename ForwardIterator, typename OutputIterator>
+	OutputIterator lower_bound_sorted(ForwardIterator keyFirst, ForwardIterator keyLast, OutputIterator out)
+	{
+		return bst.template sortedSearch<iterator>(keyFirst, keyLast, out, false);
+	}
+
+	template<typename ForwardIterator, typename OutputIterator>
+	OutputIterator lower_bound_sorted(ForwardIterator keyFirst, ForwardIterator keyLast, OutputIterator out) const
+	{
+		return bst.template sortedSearch<const_iterator>(keyFirst, keyLast, out, false);
+	}
+
+	// looks up n keys in any order: results[i] is find(keys[i]). The lookups
+	// are interleaved so that their cache misses overlap, which pays off once
+	// the map no longer fits in the caches
+	void find_batch(const key_type* keys, size_t n, iterator* results)
+	{
+		bst.findBatch(keys, n, results);
+	}
+
+	void find_batch(const key_type* keys, size_t n, const_iterator* results) const
+	{
+		bst.findBatch(keys, n, results);
+	}
+
 	ft::pair<iterator,iterator> equal_range(const key_type& k)
 	{
 		return(ft::make_pair(bst.lower_bound(bst.root, k),bst.upper_bound(bst.root, k)));
@@ -220,17 +365,23 @@ public:
 		bst.swap(x.bst);
 	}
 
+	// read-only copy laid out for lookups, see frozen_map.hpp
+	frozen_map<key_type, mapped_type, key_compare> freeze() const
+	{
+		return frozen_map<key_type, mapped_type, key_compare>(begin(), end(), size(), key_comp());
+	}
+
 	key_compare key_comp() const
 	{
-		return compare;
+		return bst.key_comp();
 	}
 	
 	value_compare value_comp() const
 	{
-		return value_compare(compare);
+		return value_compare(key_comp());
 	}
 
-	allocator_type get_allocator() const {return allocator_type(bst.allocator);}
+	allocator_type get_allocator() const {return bst.get_allocator();}
 
 	iterator begin() throw()
 	{
@@ -272,6 +423,12 @@ public:
 		return (bst.rend());
 	}
 
+	template<typename Map>
+	friend struct mapAlgebra;
+
+	template<typename Map>
+	friend struct mapSnapshot;
+
 	template<typename _K1, typename _T1, typename _C1, typename _A1>
 	friend bool operator==(const map<_K1, _T1, _C1, _A1>&, const map<_K1, _T1, _C1, _A1>&);
 
@@ -0,0 +1,456 @@
+#pragma once
+
+#include "map.hpp"
+#include "vector.hpp"
+#if __cplusplus >= 201103L
+	#include "parallel.hpp"
+#endif
+
+namespace ft
+{
+	// selects the overloads that build the result out of the input nodes
+	struct consume_t { };
+	const consume_t consume = consume_t();
+
+	// Set operations on whole maps, values always come from the first map.
+	//
+	// Intersection (and difference with the smaller map first) flattens the
+	// smaller input into a sorted slice of m nodes and walks the larger tree,
+	// only descending where a slice key can be and halving the slice at every
+	// node: O(m log(n/m + 1)) visits on a balanced tree, O(m * height) on this
+	// unbalanced one. Union, and difference with the larger map first, are
+	// linear merges: their output is O(n + m) anyway.
+	//
+	// The result is built directly as a balanced tree from the sorted matches,
+	// either from new nodes or, with ft::consume, from the input nodes
+	// themselves: the inputs are left empty and nothing is allocated.
+	//
+	// Every form also writes into an existing map given last, whose elements
+	// are replaced: map_union(a, b, out) rather than out = map_union(a, b),
+	// which would copy the whole result again. out may be a or b.
+	template<typename Map>
+	struct mapAlgebra
+	{
+		typedef typename Map::binarySearchTree	tree;
+		typedef typename Map::nodePtr			nodePtr;
+		typedef typename Map::key_compare		key_compare;
+		typedef ft::vector<nodePtr>				nodeList;
+
+		enum operation
+		{
+			UNION,
+			INTERSECTION,
+			DIFFERENCE
+		};
+
+	/******************** WALKS ********************/
+
+		static void flatten(const Map& m, nodeList& out)
+		{
+			out.reserve(m.size());
+			m.bst.collectNodes(out);
+		}
+
+	/******************** MATCHING ********************/
+
+		// a subtree of the large tree and the part of the slice that can be in it
+		struct sliceFrame
+		{
+			nodePtr	node;
+			size_t	begin;
+			size_t	count;
+
+			sliceFrame(nodePtr node, size_t begin, size_t count)
+				: node(node), begin(begin), count(count) { }
+		};
+
+		// matches[i] becomes the node of the subtree holding the key of keys[i].
+		// Left subtrees wait on an explicit stack: the tree can be as deep as
+		// it is large, so recursing on it could overflow the call stack
+		static void matchSlice(nodePtr root, const nodePtr* keys, size_t count, nodePtr* matches, const key_compare& comp)
+		{
+			ft::vector<sliceFrame> pending;
+			pending.push_back(sliceFrame(root, 0, count));
+			while (!pending.empty())
+			{
+				sliceFrame frame = pending.back();
+				pending.pop_back();
+				nodePtr node = frame.node;
+				size_t begin = frame.begin;
+				count = frame.count;
+				while (count > 0 && node != NULL)
+				{
+					// first slice key not less than the key of node
+					size_t low = 0;
+					size_t high = count;
+					while (low < high)
+					{
+						size_t mid = low + (high - low) / 2;
+						if (comp(keys[begin + mid]->data.first, node->data.first))
+							low = mid + 1;
+						else
+							high = mid;
+					}
+					if (low > 0)
+						pending.push_back(sliceFrame(node->left, begin, low));
+					if (low < count && !comp(node->data.first, keys[begin + low]->data.first))
+						matches[begin + low++] = node;
+					begin += low;
+					count -= low;
+					node = node->right;
+				}
+			}
+		}
+
+		struct serialMatcher
+		{
+			void operator()(const Map& large, const nodeList& keys, nodeList& matches) const
+			{
+				matchSlice(large.bst.root, keys.data(), keys.size(), matches.data(), large.key_comp());
+			}
+		};
+
+		// union and difference against a smaller map: one pass over both
+		static void mergeWalk(const Map& a, const Map& b, operation op, nodeList& out)
+		{
+			key_compare comp = a.key_comp();
+			nodePtr nodeA = a.bst.firstNode();
+			nodePtr nodeB = b.bst.firstNode();
+			out.reserve(op == UNION ? a.size() + b.size() : a.size());
+			while (nodeA != NULL)
+			{
+				if (nodeB == NULL || comp(nodeA->data.first, nodeB->data.first))
+				{
+					out.push_back(nodeA);
+					nodeA = a.bst.nextNode(nodeA);
+				}
+				else if (comp(nodeB->data.first, nodeA->data.first))
+				{
+					if (op == UNION)
+						out.push_back(nodeB);
+					nodeB = b.bst.nextNode(nodeB);
+				}
+				else
+				{
+					if (op == UNION)
+						out.push_back(nodeA);
+					nodeA = a.bst.nextNode(nodeA);
+					nodeB = b.bst.nextNode(nodeB);
+				}
+			}
+			for (; op == UNION && nodeB != NULL; nodeB = b.bst.nextNode(nodeB))
+				out.push_back(nodeB);
+		}
+
+		// the nodes of the result, sorted by key
+		template<typename Matcher>
+		static void collect(const Map& a, const Map& b, operation op, const Matcher& match, nodeList& out)
+		{
+			bool sliceA = a.size() <= b.size();
+			if (op == UNION || (op == DIFFERENCE && !sliceA))
+			{
+				mergeWalk(a, b, op, out);
+				return;
+			}
+			const Map& small = sliceA ? a : b;
+			const Map& large = sliceA ? b : a;
+			nodeList keys;
+			flatten(small, keys);
+			nodeList matches(keys.size(), nodePtr());
+			match(large, keys, matches);
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (op == INTERSECTION && matches[i] != NULL)
+					out.push_back(sliceA ? keys[i] : matches[i]);
+				else if (op == DIFFERENCE && matches[i] == NULL)
+					out.push_back(keys[i]);
+			}
+		}
+
+		// the nodes of m that did not make it into the result
+		static void collectDropped(const Map& m, const nodeList& out, nodeList& dropped)
+		{
+			key_compare comp = m.key_comp();
+			size_t kept = 0;
+			for (nodePtr node = m.bst.firstNode(); node != NULL; node = m.bst.nextNode(node))
+			{
+				while (kept < out.size() && comp(out[kept]->data.first, node->data.first))
+					++kept;
+				if (kept == out.size() || out[kept] != node)
+					dropped.push_back(node);
+			}
+		}
+
+	/******************** BUILDING ********************/
+
+		struct serialBuilder
+		{
+			void operator()(tree& result, nodeList& nodes, bool copy) const
+			{
+				result.buildBalanced(nodes.data(), nodes.size(), copy);
+			}
+		};
+
+		template<typename Matcher, typename Builder>
+		static Map copyOf(const Map& a, const Map& b, operation op, const Matcher& match, const Builder& build)
+		{
+			nodeList out;
+			collect(a, b, op, match, out);
+			Map result(a.key_comp(), a.get_allocator());
+			build(result.bst, out, true);
+			return result;
+		}
+
+		template<typename Matcher, typename Builder>
+		static Map consumeInputs(Map& a, Map& b, operation op, const Matcher& match, const Builder& build)
+		{
+			nodeList out;
+			collect(a, b, op, match, out);
+			// the walks need the old links: find the leftovers before relinking
+			nodeList dropped;
+			collectDropped(a, out, dropped);
+			if (&b != &a)
+				collectDropped(b, out, dropped);
+			a.bst.abandonNodes();
+			b.bst.abandonNodes();
+			Map result(a.key_comp(), a.get_allocator());
+			build(result.bst, out, false);
+			for (size_t i = 0; i < dropped.size(); i++)
+				result.bst.freeNode(dropped[i]);
+			return result;
+		}
+
+#if __cplusplus >= 201103L
+
+	/******************** PARALLEL ********************/
+
+		// slices are cut into chunks, each chunk walks the large tree on its own
+		struct parallelMatcher
+		{
+			const ft::parallel::options& opts;
+
+			void operator()(const Map& large, const nodeList& keys, nodeList& matches) const
+			{
+				key_compare comp = large.key_comp();
+				ft::parallel::forChunks(keys.size(), opts, [&large, &keys, &matches, &comp](size_t begin, size_t end)
+				{
+					matchSlice(large.bst.root, keys.data() + begin, end - begin, matches.data() + begin, comp);
+				});
+			}
+		};
+
+		static nodePtr buildParallel(tree& result, nodePtr* nodes, size_t count, typename tree::linkPtr parent, bool copy, ft::parallel::taskGroup& group, size_t grain)
+		{
+			if (count <= grain)
+				return result.buildSubtree(nodes, count, parent, copy);
+			size_t mid = count / 2;
+			nodePtr node = result.buildSubtree(nodes + mid, 1, parent, copy);
+			group.run([&result, nodes, mid, node, copy, &group, grain]()
+			{
+				node->left = buildParallel(result, nodes, mid, node, copy, group, grain);
+			});
+			node->right = buildParallel(result, nodes + mid + 1, count - mid - 1, node, copy, group, grain);
+#if BST_ORDER_STATISTICS
+			node->subtreeSize = count;
+#endif
+			return node;
+		}
+
+		// subtrees below the grain are built serially; allocating from several
+		// threads needs a thread-safe allocator, as std::allocator is
+		struct parallelBuilder
+		{
+			const ft::parallel::options& opts;
+
+			void operator()(tree& result, nodeList& nodes, bool copy) const
+			{
+				if (nodes.size() < opts.serialThreshold)
+				{
+					result.buildBalanced(nodes.data(), nodes.size(), copy);
+					return;
+				}
+				ft::parallel::taskGroup group(opts.executor());
+				nodePtr root = buildParallel(result, nodes.data(), nodes.size(), result.endNode(), copy, group, opts.grain);
+				group.wait();
+				result.adoptSubtree(root, nodes.size());
+			}
+		};
+
+#endif
+	};
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_union(const map<K, T, C, A>& a, const map<K, T, C, A>& b)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::UNION, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_union(const map<K, T, C, A>& a, const map<K, T, C, A>& b, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::UNION, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_intersection(const map<K, T, C, A>& a, const map<K, T, C, A>& b)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::INTERSECTION, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_intersection(const map<K, T, C, A>& a, const map<K, T, C, A>& b, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::INTERSECTION, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_difference(const map<K, T, C, A>& a, const map<K, T, C, A>& b)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::DIFFERENCE, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_difference(const map<K, T, C, A>& a, const map<K, T, C, A>& b, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::DIFFERENCE, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+	// consuming forms: a and b are emptied, their nodes are relinked into the
+	// result and the ones left out are freed
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_union(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::UNION, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_union(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::UNION, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_intersection(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::INTERSECTION, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_intersection(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::INTERSECTION, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_difference(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::DIFFERENCE, typename algebra::serialMatcher(), typename algebra::serialBuilder());
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_difference(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::DIFFERENCE, typename algebra::serialMatcher(), typename algebra::serialBuilder()).swap(out);
+	}
+
+#if __cplusplus >= 201103L
+
+	// parallel forms: slice matching and tree building run on the pool of opts
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_union(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::UNION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_union(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::UNION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_intersection(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::INTERSECTION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_intersection(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::INTERSECTION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_difference(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::copyOf(a, b, algebra::DIFFERENCE, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_difference(const map<K, T, C, A>& a, const map<K, T, C, A>& b, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::copyOf(a, b, algebra::DIFFERENCE, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_union(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::UNION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_union(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::UNION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_intersection(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::INTERSECTION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_intersection(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::INTERSECTION, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	map<K, T, C, A> map_difference(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		return algebra::consumeInputs(a, b, algebra::DIFFERENCE, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts});
+	}
+
+	template<typename K, typename T, typename C, typename A>
+	void map_difference(map<K, T, C, A>& a, map<K, T, C, A>& b, consume_t, const ft::parallel::options& opts, map<K, T, C, A>& out)
+	{
+		typedef mapAlgebra<map<K, T, C, A> > algebra;
+		algebra::consumeInputs(a, b, algebra::DIFFERENCE, typename algebra::parallelMatcher{opts}, typename algebra::parallelBuilder{opts}).swap(out);
+	}
+
+#endif
+}
@@ -0,0 +1,467 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "iterator.hpp"
+#include "map.hpp"
+#include "snapshot.hpp"
+#include "utils.hpp"
+
+namespace ft
+{
+	// Read-only map served straight from a file mapping.
+	//
+	//   ft::save_mapped("table.ftm", mp);	// any ft::map<Key, T, Compare>
+	//   ft::mapped_map<Key, T, Compare> table("table.ftm");
+	//
+	// The file is a snapshot header (snapshot.hpp, kind MAPPED_MAP), the
+	// sorted keys as one array and the values as a parallel array, each
+	// array starting on a 64 byte boundary. Opening maps the file and
+	// checks the header: nothing is read or copied, so opening costs the
+	// same for any size, and every process mapping the file shares its
+	// pages through the page cache. Lookups binary search the key array
+	// and iterators read both arrays in place.
+	//
+	// Key and T must be trivially copyable; the file is for the machine and
+	// build that wrote it. The keys are trusted to be sorted: checking them
+	// would read the whole file at startup.
+	namespace mapped
+	{
+		static const size_t	alignment = 64;
+
+		// magic, version, byte order, kind, key and value sizes, count
+		static const size_t	headerSize = sizeof(snapshot::magic) + 5 * sizeof(unsigned int) + sizeof(unsigned long long);
+
+		inline size_t roundUp(size_t n, size_t to)
+		{
+			return (n + to - 1) / to * to;
+		}
+
+		template<typename T>
+		size_t arrayAlignment()
+		{
+			return __alignof__(T) > alignment ? __alignof__(T) : alignment;
+		}
+
+		template<typename Key, typename T>
+		struct layout
+		{
+			// C++98 has no static_assert: a negative array size fails the build
+			typedef char	keyMustBeTriviallyCopyable[__is_trivially_copyable(Key) ? 1 : -1];
+			typedef char	valueMustBeTriviallyCopyable[__is_trivially_copyable(T) ? 1 : -1];
+
+			static size_t keysOffset()
+			{
+				return roundUp(headerSize, arrayAlignment<Key>());
+			}
+
+			static size_t valuesOffset(size_t count)
+			{
+				return roundUp(keysOffset() + count * sizeof(Key), arrayAlignment<T>());
+			}
+
+			static size_t fileSize(size_t count)
+			{
+				return valuesOffset(count) + count * sizeof(T);
+			}
+
+			// the most entries a file of size bytes can hold, so that the
+			// offsets above cannot overflow
+			static size_t maxCount(size_t size)
+			{
+				if (size < keysOffset())
+					return 0;
+				return (size - keysOffset()) / (sizeof(Key) + sizeof(T));
+			}
+		};
+
+		// the header of a mapping, read like any snapshot source
+		class memorySource
+		{
+		public:
+			memorySource(const char* data, size_t size)
+				: data(data), size(size), offset(0) { }
+
+			void read(void* to, size_t n)
+			{
+				if (n > size - offset)
+					throw snapshot_error("truncated");
+				std::memcpy(to, data + offset, n);
+				offset += n;
+			}
+
+			void finish() { }
+
+		private:
+			const char*	data;
+			size_t		size;
+			size_t		offset;
+		};
+
+		template<typename Sink>
+		void pad(Sink& sink, size_t n)
+		{
+			static const char	zeros[alignment] = { 0 };
+
+			for (; n > alignment; n -= alignment)
+				sink.write(zeros, alignment);
+			sink.write(zeros, n);
+		}
+
+		template<typename Key, typename T, typename Compare, typename Alloc>
+		void write(int fd, const ft::map<Key, T, Compare, Alloc>& mp)
+		{
+			typedef layout<Key, T>											fileLayout;
+			typedef typename ft::map<Key, T, Compare, Alloc>::const_iterator	const_iterator;
+
+			snapshot::fdSink sink(fd);
+			snapshot::header h = { snapshot::MAPPED_MAP, sizeof(Key), sizeof(T), mp.size() };
+			snapshot::writeHeader(sink, h);
+			pad(sink, fileLayout::keysOffset() - headerSize);
+			for (const_iterator it = mp.begin(); it != mp.end(); ++it)
+				sink.write(&it->first, sizeof(Key));
+			pad(sink, fileLayout::valuesOffset(mp.size()) - fileLayout::keysOffset() - mp.size() * sizeof(Key));
+			for (const_iterator it = mp.begin(); it != mp.end(); ++it)
+				sink.write(&it->second, sizeof(T));
+			sink.finish();
+		}
+	}
+
+	// Writes mp for mapped_map at the fd's offset, which should be the start
+	// of an empty file: mapped_map maps whole files.
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void save_mapped(int fd, const ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		mapped::write(fd, mp);
+	}
+
+	// Writes mp to a new file next to path, then renames it over path:
+	// processes that mapped the old file keep reading it unchanged, and the
+	// next open sees the whole new file.
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void save_mapped(const char* path, const ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		std::string temporary = std::string(path) + ".tmp";
+		int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+			throw snapshot_error(temporary + ": " + std::strerror(errno));
+		try
+		{
+			mapped::write(fd, mp);
+		}
+		catch (...)
+		{
+			::close(fd);
+			::unlink(temporary.c_str());
+			throw;
+		}
+		if (::close(fd) < 0 || ::rename(temporary.c_str(), path) < 0)
+		{
+			std::string error = std::strerror(errno);
+			::unlink(temporary.c_str());
+			throw snapshot_error(std::string(path) + ": " + error);
+		}
+	}
+
+	template<typename Key, typename T, typename Compare = std::less<Key> >
+	class mapped_map
+	{
+	public:
+		typedef Key									key_type;
+		typedef T									mapped_type;
+		typedef ft::pair<const Key, T>				value_type;
+		typedef Compare								key_compare;
+		typedef size_t								size_type;
+		typedef ptrdiff_t							difference_type;
+
+		// what an iterator points at: the key and the value in the mapping,
+		// not a copy of them
+		struct entry
+		{
+			const key_type&		first;
+			const mapped_type&	second;
+
+			entry(const key_type& first, const mapped_type& second)
+				: first(first), second(second) { }
+
+			operator value_type() const { return value_type(first, second); }
+		};
+
+		// entries are made on the fly, so -> hands out a temporary one
+		class entryPointer
+		{
+		public:
+			explicit entryPointer(const entry& e)
+				: e(e) { }
+
+			const entry* operator->() const { return &e; }
+
+		private:
+			entry	e;
+		};
+
+		typedef entry								reference;
+		typedef entry								const_reference;
+		typedef entryPointer						pointer;
+		typedef entryPointer						const_pointer;
+
+		class const_iterator
+			: public ft::iterator<std::random_access_iterator_tag, value_type, difference_type, entryPointer, entry>
+		{
+		public:
+			const_iterator()
+				: owner(NULL), index(0) { }
+
+			entry operator*() const { return owner->entryAt(index); }
+			entryPointer operator->() const { return entryPointer(owner->entryAt(index)); }
+			entry operator[](difference_type n) const { return owner->entryAt(index + n); }
+
+			const_iterator& operator++() { ++index; return *this; }
+			const_iterator& operator--() { --index; return *this; }
+
+			const_iterator operator++(int)
+			{
+				const_iterator old(*this);
+				++index;
+				return old;
+			}
+
+			const_iterator operator--(int)
+			{
+				const_iterator old(*this);
+				--index;
+				return old;
+			}
+
+			const_iterator& operator+=(difference_type n) { index += n; return *this; }
+			const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+			const_iterator operator+(difference_type n) const { return const_iterator(owner, index + n); }
+			const_iterator operator-(difference_type n) const { return const_iterator(owner, index - n); }
+			difference_type operator-(const const_iterator& rhs) const { return index - rhs.index; }
+
+			bool operator==(const const_iterator& rhs) const { return index == rhs.index; }
+			bool operator!=(const const_iterator& rhs) const { return index != rhs.index; }
+			bool operator<(const const_iterator& rhs) const { return index < rhs.index; }
+			bool operator>(const const_iterator& rhs) const { return index > rhs.index; }
+			bool operator<=(const const_iterator& rhs) const { return index <= rhs.index; }
+			bool operator>=(const const_iterator& rhs) const { return index >= rhs.index; }
+
+		private:
+			friend class mapped_map;
+
+			const_iterator(const mapped_map* owner, size_type index)
+				: owner(owner), index(index) { }
+
+			const mapped_map*	owner;
+			size_type			index;
+		};
+
+		typedef const_iterator						iterator;
+
+	private:
+		typedef mapped::layout<Key, T>				fileLayout;
+
+		const char*			base;		// the mapping, NULL when closed
+		size_type			mappedSize;
+		const key_type*		keys;
+		const mapped_type*	values;
+		size_type			length;
+		key_compare			comp;
+
+		// the mapping is not shared between objects
+		mapped_map(const mapped_map&);
+		mapped_map& operator=(const mapped_map&);
+
+	public:
+		explicit mapped_map(const key_compare& comp = key_compare())
+			: base(NULL), mappedSize(0), keys(NULL), values(NULL), length(0), comp(comp) { }
+
+		explicit mapped_map(const char* path, const key_compare& comp = key_compare())
+			: base(NULL), mappedSize(0), keys(NULL), values(NULL), length(0), comp(comp)
+		{
+			open(path);
+		}
+
+		~mapped_map()
+		{
+			close();
+		}
+
+		// replaces what was open; on error the map is left closed and empty
+		void open(const char* path)
+		{
+			int fd = ::open(path, O_RDONLY);
+			if (fd < 0)
+				throw snapshot_error(std::string(path) + ": " + std::strerror(errno));
+			try
+			{
+				open(fd);
+			}
+			catch (...)
+			{
+				::close(fd);
+				throw;
+			}
+			::close(fd);
+		}
+
+		// maps the whole file behind fd; the fd can be closed afterwards
+		void open(int fd)
+		{
+			close();
+			struct stat info;
+			if (::fstat(fd, &info) < 0)
+				throw snapshot_error(std::string("stat failed: ") + std::strerror(errno));
+			size_type size = info.st_size;
+			if (size < mapped::headerSize)
+				throw snapshot_error("truncated");
+			void* mapping = ::mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+			if (mapping == MAP_FAILED)
+				throw snapshot_error(std::string("mmap failed: ") + std::strerror(errno));
+			base = static_cast<const char*>(mapping);
+			mappedSize = size;
+			try
+			{
+				mapped::memorySource source(base, size);
+				snapshot::header expected = { snapshot::MAPPED_MAP, sizeof(Key), sizeof(T), 0 };
+				unsigned long long count = snapshot::readHeader(source, expected);
+				if (count > fileLayout::maxCount(size) || fileLayout::fileSize(count) > size)
+					throw snapshot_error("truncated");
+				length = count;
+				keys = reinterpret_cast<const key_type*>(base + fileLayout::keysOffset());
+				values = reinterpret_cast<const mapped_type*>(base + fileLayout::valuesOffset(length));
+			}
+			catch (...)
+			{
+				close();
+				throw;
+			}
+		}
+
+		void close()
+		{
+			if (base)
+				::munmap(const_cast<char*>(base), mappedSize);
+			base = NULL;
+			mappedSize = 0;
+			keys = NULL;
+			values = NULL;
+			length = 0;
+		}
+
+		bool is_open() const { return base != NULL; }
+
+	/******************** ITERATORS ********************/
+
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, length); }
+
+	/******************** CAPACITY ********************/
+
+		bool empty() const { return length == 0; }
+		size_type size() const { return length; }
+
+	/******************** LOOKUP ********************/
+
+		const mapped_type& at(const key_type& k) const
+		{
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("mapped_map out of range");
+			return values[it.index];
+		}
+
+		const_iterator find(const key_type& k) const
+		{
+			size_type index = lowerBoundIndex(k);
+			if (index == length || comp(k, keys[index]))
+				return end();
+			return const_iterator(this, index);
+		}
+
+		size_type count(const key_type& k) const
+		{
+			return find(k) != end();
+		}
+
+		const_iterator lower_bound(const key_type& k) const
+		{
+			return const_iterator(this, lowerBoundIndex(k));
+		}
+
+		const_iterator upper_bound(const key_type& k) const
+		{
+			if (length == 0)
+				return end();
+			const key_type* base = keys;
+			for (size_type n = length; n > 1; n -= n / 2)
+			{
+				__builtin_prefetch(base + n / 4);
+				__builtin_prefetch(base + n / 2 + n / 4);
+				base = comp(k, base[n / 2]) ? base : base + n / 2;
+			}
+			return const_iterator(this, base - keys + !comp(k, *base));
+		}
+
+		ft::pair<const_iterator, const_iterator> equal_range(const key_type& k) const
+		{
+			return ft::make_pair(lower_bound(k), upper_bound(k));
+		}
+
+		key_compare key_comp() const { return comp; }
+
+	/******************** MODIFIERS ********************/
+
+		void swap(mapped_map& other)
+		{
+			std::swap(base, other.base);
+			std::swap(mappedSize, other.mappedSize);
+			std::swap(keys, other.keys);
+			std::swap(values, other.values);
+			std::swap(length, other.length);
+			std::swap(comp, other.comp);
+		}
+
+	private:
+		friend class const_iterator;
+
+		// Halves the range with a select rather than a branch, which a
+		// random key would mispredict half of the time, and prefetches the
+		// middles of both possible halves while the comparison runs
+		size_type lowerBoundIndex(const key_type& k) const
+		{
+			if (length == 0)
+				return 0;
+			const key_type* base = keys;
+			for (size_type n = length; n > 1; n -= n / 2)
+			{
+				__builtin_prefetch(base + n / 4);
+				__builtin_prefetch(base + n / 2 + n / 4);
+				base = comp(base[n / 2], k) ? base + n / 2 : base;
+			}
+			return base - keys + comp(*base, k);
+		}
+
+		entry entryAt(size_type index) const
+		{
+			return entry(keys[index], values[index]);
+		}
+	};
+
+	template<typename Key, typename T, typename Compare>
+	void swap(mapped_map<Key, T, Compare>& lhs, mapped_map<Key, T, Compare>& rhs)
+	{
+		lhs.swap(rhs);
+	}
+}
@@ -0,0 +1,391 @@
+#pragma once
+
+#if __cplusplus < 201103L
+	#error "parallel.hpp requires C++11 (std::thread and std::atomic)"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vector.hpp"
+
+namespace ft
+{
+	namespace parallel
+	{
+		typedef std::function<void()> task;
+
+	/********************	 THREAD POOL	 *********************/
+
+		// every worker owns a deque: it pops its own work from the back and
+		// idle workers steal the oldest (usually biggest) tasks from the front;
+		// the thread calling an algorithm helps the workers until its work is done
+		class threadPool
+		{
+			struct workQueue
+			{
+				std::mutex			lock;
+				std::deque<task>	tasks;
+			};
+
+		public:
+			explicit threadPool(unsigned threadCount = std::thread::hardware_concurrency())
+				: queues(), threads(), stopping(false), queued(0), nextQueue(0)
+			{
+				if (threadCount == 0)
+					threadCount = 1;
+				for (unsigned i = 0; i < threadCount; i++)
+					queues.push_back(std::unique_ptr<workQueue>(new workQueue()));
+				for (unsigned i = 0; i < threadCount; i++)
+					threads.push_back(std::thread(&threadPool::workerLoop, this, i));
+			}
+
+			~threadPool()
+			{
+				{
+					std::lock_guard<std::mutex> guard(sleepLock);
+					stopping = true;
+				}
+				wake.notify_all();
+				for (size_t i = 0; i < threads.size(); i++)
+					threads[i].join();
+			}
+
+			threadPool(const threadPool&) = delete;
+			threadPool& operator=(const threadPool&) = delete;
+
+			size_t size() const
+			{
+				return threads.size();
+			}
+
+			void push(task work)
+			{
+				size_t idx = (current().pool == this) ? current().index : nextQueue++ % queues.size();
+				{
+					std::lock_guard<std::mutex> guard(queues[idx]->lock);
+					queues[idx]->tasks.push_back(std::move(work));
+				}
+				{
+					std::lock_guard<std::mutex> guard(sleepLock);
+					++queued;
+				}
+				wake.notify_one();
+			}
+
+			// runs one queued task on the calling thread, false if there was none
+			bool runPending()
+			{
+				task work;
+				size_t self = (current().pool == this) ? current().index : 0;
+				if (!popTask(self, work))
+					return false;
+				work();
+				return true;
+			}
+
+		private:
+			struct threadSlot
+			{
+				threadPool*	pool;
+				size_t		index;
+			};
+
+			static threadSlot& current()
+			{
+				static thread_local threadSlot slot = { NULL, 0 };
+				return slot;
+			}
+
+			bool popTask(size_t self, task& work)
+			{
+				{
+					std::lock_guard<std::mutex> guard(queues[self]->lock);
+					if (!queues[self]->tasks.empty())
+					{
+						work = std::move(queues[self]->tasks.back());
+						queues[self]->tasks.pop_back();
+						--queued;
+						return true;
+					}
+				}
+				for (size_t i = 1; i < queues.size(); i++)
+				{
+					workQueue& victim = *queues[(self + i) % queues.size()];
+					std::lock_guard<std::mutex> guard(victim.lock);
+					if (!victim.tasks.empty())
+					{
+						work = std::move(victim.tasks.front());
+						victim.tasks.pop_front();
+						--queued;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void workerLoop(size_t index)
+			{
+				current().pool = this;
+				current().index = index;
+				while (true)
+				{
+					if (runPending())
+						continue;
+					std::unique_lock<std::mutex> guard(sleepLock);
+					wake.wait(guard, [this] { return stopping || queued > 0; });
+					if (stopping && queued == 0)
+						return;
+				}
+			}
+
+			std::vector<std::unique_ptr<workQueue> >	queues;
+			std::vector<std::thread>					threads;
+			std::mutex									sleepLock;
+			std::condition_variable						wake;
+			bool										stopping;
+			std::atomic<size_t>							queued;
+			std::atomic<size_t>							nextQueue;
+		};
+
+		inline threadPool& defaultPool()
+		{
+			static threadPool pool;
+			return pool;
+		}
+
+	/********************	 TASK GROUP	 *********************/
+
+		// fork-join scope: wait() helps executing queued work instead of blocking,
+		// so nested groups (recursive sort) cannot starve the pool
+		class taskGroup
+		{
+		public:
+			explicit taskGroup(threadPool& pool)
+				: pool(pool), pending(0), error() { }
+
+			~taskGroup()
+			{
+				while (pending > 0)
+					if (!pool.runPending())
+						std::this_thread::yield();
+			}
+
+			void run(task work)
+			{
+				++pending;
+				pool.push([this, work]()
+				{
+					try
+					{
+						work();
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> guard(errorLock);
+						if (!error)
+							error = std::current_exception();
+					}
+					--pending;
+				});
+			}
+
+			void wait()
+			{
+				while (pending > 0)
+					if (!pool.runPending())
+						std::this_thread::yield();
+				if (error)
+					std::rethrow_exception(error);
+			}
+
+		private:
+			threadPool&			pool;
+			std::atomic<size_t>	pending;
+			std::mutex			errorLock;
+			std::exception_ptr	error;
+		};
+
+	/********************	 OPTIONS	 *********************/
+
+		// grain: elements handled by one leaf task
+		// serialThreshold: ranges shorter than this never leave the calling thread
+		struct options
+		{
+			threadPool*	pool;
+			size_t		grain;
+			size_t		serialThreshold;
+
+			options(threadPool* pool = NULL, size_t grain = 1 << 14, size_t serialThreshold = 1 << 15)
+				: pool(pool), grain(grain ? grain : 1), serialThreshold(serialThreshold) { }
+
+			threadPool& executor() const
+			{
+				return pool ? *pool : defaultPool();
+			}
+		};
+
+		// splits [begin, end) in halves down to the grain, one half is spawned
+		// and the other kept, so stolen tasks are always the large ones
+		template<typename Body>
+		void splitRange(taskGroup& group, size_t begin, size_t end, size_t grain, const Body& body)
+		{
+			while (end - begin > grain)
+			{
+				size_t mid = begin + ((end - begin) / 2 + grain - 1) / grain * grain;
+				if (mid >= end)
+					break;
+				size_t spawnEnd = end;
+				group.run([&group, mid, spawnEnd, grain, &body]() { splitRange(group, mid, spawnEnd, grain, body); });
+				end = mid;
+			}
+			body(begin, end);
+		}
+
+		template<typename Body>
+		void forChunks(size_t n, const options& opts, const Body& body)
+		{
+			if (n < opts.serialThreshold)
+			{
+				body(0, n);
+				return;
+			}
+			taskGroup group(opts.executor());
+			splitRange(group, 0, n, opts.grain, body);
+			group.wait();
+		}
+
+	/********************	 ALGORITHMS	 *********************/
+
+		template<typename RandomAccessIterator, typename Function>
+		void for_each(RandomAccessIterator first, RandomAccessIterator last, Function f, const options& opts = options())
+		{
+			forChunks(last - first, opts, [first, &f](size_t begin, size_t end)
+			{
+				for (RandomAccessIterator it = first + begin; it != first + end; ++it)
+					f(*it);
+			});
+		}
+
+		template<typename RandomAccessIterator, typename OutputIterator, typename UnaryOperation>
+		OutputIterator transform(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, UnaryOperation op, const options& opts = options())
+		{
+			forChunks(last - first, opts, [first, result, &op](size_t begin, size_t end)
+			{
+				std::transform(first + begin, first + end, result + begin, op);
+			});
+			return result + (last - first);
+		}
+
+		template<typename RandomAccessIterator1, typename RandomAccessIterator2, typename OutputIterator, typename BinaryOperation>
+		OutputIterator transform(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, OutputIterator result, BinaryOperation op, const options& opts = options())
+		{
+			forChunks(last1 - first1, opts, [first1, first2, result, &op](size_t begin, size_t end)
+			{
+				std::transform(first1 + begin, first1 + end, first2 + begin, result + begin, op);
+			});
+			return result + (last1 - first1);
+		}
+
+		// op must be associative: partial sums of the chunks are combined in order
+		template<typename RandomAccessIterator, typename T, typename BinaryOperation>
+		T reduce(RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation op, const options& opts = options())
+		{
+			size_t n = last - first;
+			if (n == 0)
+				return init;
+			size_t chunks = (n + opts.grain - 1) / opts.grain;
+			ft::vector<T> partials(chunks, init);
+			size_t grain = opts.grain;
+			forChunks(n, opts, [first, &op, &partials, grain](size_t begin, size_t end)
+			{
+				for (; begin < end; begin += grain)
+				{
+					size_t stop = std::min(begin + grain, end);
+					T sum = first[begin];
+					for (size_t i = begin + 1; i < stop; i++)
+						sum = op(sum, first[i]);
+					partials[begin / grain] = sum;
+				}
+			});
+			for (size_t i = 0; i < chunks; i++)
+				init = op(init, partials[i]);
+			return init;
+		}
+
+		template<typename RandomAccessIterator, typename T>
+		T reduce(RandomAccessIterator first, RandomAccessIterator last, T init)
+		{
+			return reduce(first, last, init, std::plus<T>());
+		}
+
+		template<typename RandomAccessIterator, typename T>
+		void fill(RandomAccessIterator first, RandomAccessIterator last, const T& value, const options& opts = options())
+		{
+			forChunks(last - first, opts, [first, &value](size_t begin, size_t end)
+			{
+				std::fill(first + begin, first + end, value);
+			});
+		}
+
+		template<typename RandomAccessIterator, typename OutputIterator>
+		OutputIterator copy(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, const options& opts = options())
+		{
+			forChunks(last - first, opts, [first, result](size_t begin, size_t end)
+			{
+				std::copy(first + begin, first + end, result + begin);
+			});
+			return result + (last - first);
+		}
+
+		template<typename RandomAccessIterator, typename Compare>
+		void sortTask(taskGroup& group, RandomAccessIterator first, RandomAccessIterator last, Compare comp, size_t grain)
+		{
+			while (static_cast<size_t>(last - first) > grain)
+			{
+				RandomAccessIterator mid = first + (last - first) / 2;
+				// median of three keeps sorted and reversed input balanced
+				if (comp(*mid, *first))
+					std::iter_swap(mid, first);
+				if (comp(*(last - 1), *mid))
+				{
+					std::iter_swap(last - 1, mid);
+					if (comp(*mid, *first))
+						std::iter_swap(mid, first);
+				}
+				typename ft::iterator_traits<RandomAccessIterator>::value_type pivot = *mid;
+				RandomAccessIterator split = std::partition(first, last, [&pivot, &comp](const typename ft::iterator_traits<RandomAccessIterator>::value_type& v) { return comp(v, pivot); });
+				RandomAccessIterator equalEnd = std::partition(split, last, [&pivot, &comp](const typename ft::iterator_traits<RandomAccessIterator>::value_type& v) { return !comp(pivot, v); });
+				group.run([&group, equalEnd, last, comp, grain]() { sortTask(group, equalEnd, last, comp, grain); });
+				last = split;
+			}
+			std::sort(first, last, comp);
+		}
+
+		template<typename RandomAccessIterator, typename Compare>
+		void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp, const options& opts = options())
+		{
+			if (static_cast<size_t>(last - first) < opts.serialThreshold)
+			{
+				std::sort(first, last, comp);
+				return;
+			}
+			taskGroup group(opts.executor());
+			sortTask(group, first, last, comp, opts.grain);
+			group.wait();
+		}
+
+		template<typename RandomAccessIterator>
+		void sort(RandomAccessIterator first, RandomAccessIterator last)
+		{
+			parallel::sort(first, last, std::less<typename ft::iterator_traits<RandomAccessIterator>::value_type>());
+		}
+	}
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include "iterator.hpp"
+#include "utils.hpp"
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+	#include <immintrin.h>
+	#define FT_SIMD_X86 1
+#else
+	#define FT_SIMD_X86 0
+#endif
+
+namespace ft
+{
+	namespace simd
+	{
+
+	/********************	 MISMATCH KERNELS	 *********************/
+
+		// every kernel returns the index of the first differing byte, or n
+		inline size_t mismatchScalar(const unsigned char* a, const unsigned char* b, size_t n)
+		{
+			size_t i = 0;
+			while (i < n && a[i] == b[i])
+				++i;
+			return i;
+		}
+
+#if FT_SIMD_X86
+		inline size_t mismatchSse2(const unsigned char* a, const unsigned char* b, size_t n)
+		{
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16)
+			{
+				__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+				unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) ^ 0xFFFFu;
+				if (mask)
+					return i + __builtin_ctz(mask);
+			}
+			return i + mismatchScalar(a + i, b + i, n - i);
+		}
+
+		__attribute__((target("avx2")))
+		inline size_t mismatchAvx2(const unsigned char* a, const unsigned char* b, size_t n)
+		{
+			size_t i = 0;
+			// two vectors per iteration, the mismatch is located by the loop below
+			for (; i + 64 <= n; i += 64)
+			{
+				__m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+				__m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)),
+												_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+				if (_mm256_movemask_epi8(_mm256_and_si256(eq0, eq1)) != -1)
+					break;
+			}
+			for (; i + 32 <= n; i += 32)
+			{
+				__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+				unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+				if (mask)
+					return i + __builtin_ctz(mask);
+			}
+			return i + mismatchSse2(a + i, b + i, n - i);
+		}
+#endif
+
+		typedef size_t (*mismatchFunction)(const unsigned char*, const unsigned char*, size_t);
+
+		inline mismatchFunction selectMismatch()
+		{
+#if FT_SIMD_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return mismatchAvx2;
+			return mismatchSse2;
+#else
+			return mismatchScalar;
+#endif
+		}
+
+		// the kernel is picked once per process from the running CPU
+		inline size_t mismatch(const void* a, const void* b, size_t n)
+		{
+			static const mismatchFunction kernel = selectMismatch();
+			return kernel(static_cast<const unsigned char*>(a), static_cast<const unsigned char*>(b), n);
+		}
+
+	/********************	 TRAITS	 *********************/
+
+		template<typename Pointer>
+		struct contiguousValue
+		{
+			typedef void type;
+		};
+
+		template<typename T>
+		struct contiguousValue<T*>
+		{
+			typedef T type;
+		};
+
+		template<typename T>
+		struct contiguousValue<const T*>
+		{
+			typedef T type;
+		};
+
+		// integers compare equal exactly when their object representations do
+		template<typename Pointer1, typename Pointer2>
+		struct bitwiseComparable
+		{
+			typedef typename contiguousValue<Pointer1>::type value_type;
+
+			static const bool value = ft::are_same<value_type, typename contiguousValue<Pointer2>::type>::value
+									&& ft::is_integral<value_type>::value;
+		};
+
+		// types whose ordering is the unsigned byte ordering used by memcmp
+		template<typename T>
+		struct byteOrdered : public false_type {};
+
+		template<>
+		struct byteOrdered<unsigned char> : public true_type {};
+
+		template<>
+		struct byteOrdered<bool> : public true_type {};
+	}
+
+	/********************	 CONTIGUOUS OVERLOADS	 *********************/
+
+	template<typename Pointer1, typename Pointer2>
+	typename ft::enable_if<simd::bitwiseComparable<Pointer1, Pointer2>::value, bool>::type
+	equal(vectorIterator<Pointer1> first1, vectorIterator<Pointer1> last1, vectorIterator<Pointer2> first2)
+	{
+		typedef typename simd::contiguousValue<Pointer1>::type value_type;
+
+		size_t bytes = (last1 - first1) * sizeof(value_type);
+		if (bytes == 0)
+			return true;
+		if (sizeof(value_type) == 1)
+			return std::memcmp(first1.base(), first2.base(), bytes) == 0;
+		return simd::mismatch(first1.base(), first2.base(), bytes) == bytes;
+	}
+
+	template<typename Pointer1, typename Pointer2>
+	typename ft::enable_if<simd::bitwiseComparable<Pointer1, Pointer2>::value, bool>::type
+	lexicographical_compare(vectorIterator<Pointer1> first1, vectorIterator<Pointer1> last1, vectorIterator<Pointer2> first2, vectorIterator<Pointer2> last2)
+	{
+		typedef typename simd::contiguousValue<Pointer1>::type value_type;
+
+		size_t size1 = last1 - first1;
+		size_t size2 = last2 - first2;
+		size_t n = size1 < size2 ? size1 : size2;
+		if (n == 0)
+			return size1 < size2;
+		if (simd::byteOrdered<value_type>::value)
+		{
+			int diff = std::memcmp(first1.base(), first2.base(), n);
+			return diff != 0 ? diff < 0 : size1 < size2;
+		}
+		size_t idx = simd::mismatch(first1.base(), first2.base(), n * sizeof(value_type)) / sizeof(value_type);
+		if (idx < n)
+			return first1[idx] < first2[idx];
+		return size1 < size2;
+	}
+}
@@ -0,0 +1,515 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "map.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// Binary snapshots of ft::vector and ft::map.
+	//
+	//   ft::save(out, container);	// std::ostream&, or a file descriptor
+	//   ft::load(in, container);	// std::istream&, or a file descriptor
+	//
+	// A snapshot is a header (magic, version, byte order, element sizes,
+	// count) followed by the elements. A vector of trivially copyable
+	// elements is written and read as one block; a map is written in key
+	// order and loaded into a balanced tree in O(n), without one insert per
+	// element. Snapshots are for the machine and build that wrote them: the
+	// byte order and element sizes are checked, not converted.
+	//
+	// Errors throw snapshot_error and leave the loaded container empty.
+	// Loading from a file descriptor reads ahead with pread, so the
+	// descriptor must be seekable (a file); it is left just after the
+	// snapshot, ready for the next one.
+
+	struct snapshot_error : public std::runtime_error
+	{
+		explicit snapshot_error(const std::string& what)
+			: std::runtime_error("snapshot: " + what) { }
+	};
+
+	// How one element is stored. Trivially copyable types are stored as
+	// their bytes; other types need a snapshot_value<T, false> with the
+	// same members, as std::basic_string has below. size is sizeof(T) for
+	// types stored as bytes and 0 otherwise; it goes in the header
+	template<typename T, bool Bytes = __is_trivially_copyable(T)>
+	struct snapshot_value;
+
+	template<typename T>
+	struct snapshot_value<T, true>
+	{
+		static const unsigned int size = sizeof(T);
+
+		template<typename Sink>
+		static void write(Sink& sink, const T& value)
+		{
+			sink.write(&value, sizeof(T));
+		}
+
+		template<typename Source>
+		static void read(Source& source, T& value)
+		{
+			source.read(&value, sizeof(T));
+		}
+	};
+
+	// the length, then the characters
+	template<typename Char, typename Traits, typename Alloc>
+	struct snapshot_value<std::basic_string<Char, Traits, Alloc>, false>
+	{
+		typedef std::basic_string<Char, Traits, Alloc>	string;
+
+		static const unsigned int size = 0;
+
+		template<typename Sink>
+		static void write(Sink& sink, const string& value)
+		{
+			unsigned long long length = value.size();
+			sink.write(&length, sizeof(length));
+			sink.write(value.data(), value.size() * sizeof(Char));
+		}
+
+		template<typename Source>
+		static void read(Source& source, string& value)
+		{
+			unsigned long long length;
+			source.read(&length, sizeof(length));
+			if (length > value.max_size())
+				throw snapshot_error("string too long");
+			value.resize(length);
+			if (length)
+				source.read(&value[0], length * sizeof(Char));
+		}
+	};
+
+	// friend of ft::vector: trivially copyable elements are read straight
+	// into reserved storage, which resize would value-initialise first for
+	// nothing. vec is empty; it only grows once the read went through
+	template<typename Vector>
+	struct vectorSnapshot
+	{
+		template<typename Source>
+		static void readBytes(Source& source, Vector& vec, size_t count)
+		{
+			vec.reserve(count);
+			if (count == 0)
+				return;
+			source.read(vec.vectorBaseVar.start, count * sizeof(typename Vector::value_type));
+			vec.vectorBaseVar.finish = vec.vectorBaseVar.start + count;
+		}
+	};
+
+	namespace snapshot
+	{
+		static const char			magic[4] = { 'f', 't', 's', 'n' };
+		static const unsigned int	version = 1;
+		static const unsigned int	byteOrder = 0x01020304;
+		// the most one read(2) or write(2) is asked for; Linux moves at
+		// most 2 GiB - 4 KiB per call anyway
+		static const size_t			ioChunk = size_t(1) << 30;
+		static const size_t			bufferSize = size_t(1) << 20;
+
+		enum kind
+		{
+			VECTOR = 1,
+			MAP = 2,
+			MAPPED_MAP = 3		// see mapped_map.hpp
+		};
+
+		inline const char* kindName(unsigned int k)
+		{
+			return k == VECTOR ? "a vector" : k == MAP ? "a map" : k == MAPPED_MAP ? "a mapped map" : "something else";
+		}
+
+		struct header
+		{
+			unsigned int		kind;
+			unsigned int		keySize;		// the element of a vector
+			unsigned int		valueSize;		// 0 for a vector
+			unsigned long long	count;
+		};
+
+	/******************** SINKS AND SOURCES ********************/
+
+		class streamSink
+		{
+		public:
+			explicit streamSink(std::ostream& out)
+				: out(out) { }
+
+			void write(const void* data, size_t n)
+			{
+				if (!out.write(static_cast<const char*>(data), n))
+					throw snapshot_error("write failed");
+			}
+
+			void finish()
+			{
+				if (!out.flush())
+					throw snapshot_error("write failed");
+			}
+
+		private:
+			std::ostream&	out;
+		};
+
+		// small writes gather in a buffer, large ones go straight to the fd
+		class fdSink
+		{
+		public:
+			explicit fdSink(int fd)
+				: fd(fd), buffer(bufferSize), used(0) { }
+
+			void write(const void* data, size_t n)
+			{
+				if (used + n > buffer.size())
+				{
+					flush();
+					if (n >= buffer.size())
+					{
+						writeAll(data, n);
+						return;
+					}
+				}
+				std::memcpy(&buffer[used], data, n);
+				used += n;
+			}
+
+			void finish()
+			{
+				flush();
+			}
+
+		private:
+			void flush()
+			{
+				writeAll(buffer.data(), used);
+				used = 0;
+			}
+
+			void writeAll(const void* data, size_t n)
+			{
+				const char* bytes = static_cast<const char*>(data);
+				while (n > 0)
+				{
+					ssize_t written = ::write(fd, bytes, n < ioChunk ? n : ioChunk);
+					if (written < 0 && errno == EINTR)
+						continue;
+					if (written <= 0)
+						throw snapshot_error(std::string("write failed: ") + std::strerror(errno));
+					bytes += written;
+					n -= written;
+				}
+			}
+
+			int					fd;
+			ft::vector<char>	buffer;
+			size_t				used;
+		};
+
+		// reads exactly what it is asked for: a stream cannot be rewound past
+		// what was read ahead
+		class streamSource
+		{
+		public:
+			explicit streamSource(std::istream& in)
+				: in(in) { }
+
+			void read(void* data, size_t n)
+			{
+				if (!in.read(static_cast<char*>(data), n))
+					throw snapshot_error("truncated");
+			}
+
+			void finish() { }
+
+		private:
+			std::istream&	in;
+		};
+
+		// preads from its own offset, buffering small reads, and moves the
+		// fd offset past what was consumed when done
+		class fdSource
+		{
+		public:
+			explicit fdSource(int fd)
+				: fd(fd), offset(::lseek(fd, 0, SEEK_CUR)), buffer(bufferSize), first(0), last(0)
+			{
+				if (offset < 0)
+					throw snapshot_error(std::string("cannot load from this fd: ") + std::strerror(errno));
+			}
+
+			void read(void* data, size_t n)
+			{
+				char* bytes = static_cast<char*>(data);
+				size_t buffered = last - first;
+				if (n <= buffered)
+				{
+					std::memcpy(bytes, &buffer[first], n);
+					first += n;
+					return;
+				}
+				std::memcpy(bytes, &buffer[first], buffered);
+				bytes += buffered;
+				n -= buffered;
+				first = 0;
+				last = 0;
+				if (n >= buffer.size())
+					readAll(bytes, n, n);
+				else
+				{
+					last = readAll(buffer.data(), n, buffer.size());
+					std::memcpy(bytes, buffer.data(), n);
+					first = n;
+				}
+			}
+
+			void finish()
+			{
+				if (::lseek(fd, offset - static_cast<off_t>(last - first), SEEK_SET) < 0)
+					throw snapshot_error(std::string("seek failed: ") + std::strerror(errno));
+			}
+
+		private:
+			// reads at least need and at most n bytes, returns how many
+			size_t readAll(char* bytes, size_t need, size_t n)
+			{
+				size_t done = 0;
+				while (done < need)
+				{
+					size_t ask = n - done < ioChunk ? n - done : ioChunk;
+					ssize_t got = ::pread(fd, bytes + done, ask, offset);
+					if (got < 0 && errno == EINTR)
+						continue;
+					if (got < 0)
+						throw snapshot_error(std::string("read failed: ") + std::strerror(errno));
+					if (got == 0)
+						throw snapshot_error("truncated");
+					done += got;
+					offset += got;
+				}
+				return done;
+			}
+
+			int					fd;
+			off_t				offset;
+			ft::vector<char>	buffer;
+			size_t				first;
+			size_t				last;
+		};
+
+	/******************** HEADER ********************/
+
+		template<typename Sink>
+		void writeHeader(Sink& sink, const header& h)
+		{
+			sink.write(magic, sizeof(magic));
+			sink.write(&version, sizeof(version));
+			sink.write(&byteOrder, sizeof(byteOrder));
+			sink.write(&h.kind, sizeof(h.kind));
+			sink.write(&h.keySize, sizeof(h.keySize));
+			sink.write(&h.valueSize, sizeof(h.valueSize));
+			sink.write(&h.count, sizeof(h.count));
+		}
+
+		// checks everything but the count, which it returns
+		template<typename Source>
+		unsigned long long readHeader(Source& source, const header& expected)
+		{
+			char readMagic[sizeof(magic)];
+			header h;
+			unsigned int readVersion;
+			unsigned int readOrder;
+			source.read(readMagic, sizeof(readMagic));
+			if (std::memcmp(readMagic, magic, sizeof(magic)) != 0)
+				throw snapshot_error("not a snapshot");
+			source.read(&readVersion, sizeof(readVersion));
+			source.read(&readOrder, sizeof(readOrder));
+			if (readOrder != byteOrder)
+				throw snapshot_error("written with another byte order");
+			if (readVersion != version)
+				throw snapshot_error("unsupported version");
+			source.read(&h.kind, sizeof(h.kind));
+			source.read(&h.keySize, sizeof(h.keySize));
+			source.read(&h.valueSize, sizeof(h.valueSize));
+			source.read(&h.count, sizeof(h.count));
+			if (h.kind != expected.kind)
+				throw snapshot_error(std::string("holds ") + kindName(h.kind));
+			if (h.keySize != expected.keySize || h.valueSize != expected.valueSize)
+				throw snapshot_error("element types differ");
+			return h.count;
+		}
+
+	/******************** VECTOR ********************/
+
+		template<typename Sink, typename T, typename Alloc>
+		void writeVector(Sink& sink, const ft::vector<T, Alloc>& vec)
+		{
+			header h = { VECTOR, snapshot_value<T>::size, 0, vec.size() };
+			writeHeader(sink, h);
+			if (__is_trivially_copyable(T))
+			{
+				if (!vec.empty())
+					sink.write(vec.data(), vec.size() * sizeof(T));
+			}
+			else
+				for (size_t i = 0; i < vec.size(); i++)
+					snapshot_value<T>::write(sink, vec[i]);
+			sink.finish();
+		}
+
+		template<typename Source, typename T, typename Alloc>
+		void readVector(Source& source, ft::vector<T, Alloc>& vec)
+		{
+			vec.clear();
+			try
+			{
+				header expected = { VECTOR, snapshot_value<T>::size, 0, 0 };
+				unsigned long long count = readHeader(source, expected);
+				if (count > vec.max_size())
+					throw snapshot_error("too many elements");
+				if (__is_trivially_copyable(T))
+					vectorSnapshot<ft::vector<T, Alloc> >::readBytes(source, vec, count);
+				else
+				{
+					vec.resize(count);
+					for (size_t i = 0; i < count; i++)
+						snapshot_value<T>::read(source, vec[i]);
+				}
+				source.finish();
+			}
+			catch (...)
+			{
+				vec.clear();
+				throw;
+			}
+		}
+	}
+
+	/******************** MAP ********************/
+
+	// friend of ft::map: loading links the nodes into a balanced tree itself
+	template<typename Map>
+	struct mapSnapshot
+	{
+		typedef typename Map::key_type			key_type;
+		typedef typename Map::mapped_type		mapped_type;
+		typedef typename Map::value_type		value_type;
+		typedef typename Map::nodePtr			nodePtr;
+
+		template<typename Sink>
+		static void write(Sink& sink, const Map& mp)
+		{
+			snapshot::header h = { snapshot::MAP, snapshot_value<key_type>::size, snapshot_value<mapped_type>::size, mp.size() };
+			snapshot::writeHeader(sink, h);
+			for (typename Map::const_iterator it = mp.begin(); it != mp.end(); ++it)
+			{
+				snapshot_value<key_type>::write(sink, it->first);
+				snapshot_value<mapped_type>::write(sink, it->second);
+			}
+			sink.finish();
+		}
+
+		// O(n): the keys come sorted, so the nodes are linked balanced
+		// without a search each
+		template<typename Source>
+		static void read(Source& source, Map& mp)
+		{
+			mp.clear();
+			snapshot::header expected = { snapshot::MAP, snapshot_value<key_type>::size, snapshot_value<mapped_type>::size, 0 };
+			unsigned long long count = snapshot::readHeader(source, expected);
+			if (count > mp.max_size())
+				throw snapshot_error("too many elements");
+			ft::vector<nodePtr> nodes;
+			try
+			{
+				nodes.reserve(count);
+				key_type key;
+				mapped_type mapped;
+				for (size_t i = 0; i < count; i++)
+				{
+					snapshot_value<key_type>::read(source, key);
+					snapshot_value<mapped_type>::read(source, mapped);
+					if (i > 0 && !mp.key_comp()(nodes.back()->data.first, key))
+						throw snapshot_error("keys out of order");
+					nodes.push_back(mp.bst.newNode(value_type(key, mapped), mp.bst.endNode()));
+				}
+				source.finish();
+			}
+			catch (...)
+			{
+				for (size_t i = 0; i < nodes.size(); i++)
+					mp.bst.freeNode(nodes[i]);
+				throw;
+			}
+			if (count)
+				mp.bst.buildBalanced(nodes.data(), count, false);
+		}
+	};
+
+	/******************** SAVE AND LOAD ********************/
+
+	template<typename T, typename Alloc>
+	void save(std::ostream& out, const ft::vector<T, Alloc>& vec)
+	{
+		snapshot::streamSink sink(out);
+		snapshot::writeVector(sink, vec);
+	}
+
+	template<typename T, typename Alloc>
+	void save(int fd, const ft::vector<T, Alloc>& vec)
+	{
+		snapshot::fdSink sink(fd);
+		snapshot::writeVector(sink, vec);
+	}
+
+	template<typename T, typename Alloc>
+	void load(std::istream& in, ft::vector<T, Alloc>& vec)
+	{
+		snapshot::streamSource source(in);
+		snapshot::readVector(source, vec);
+	}
+
+	template<typename T, typename Alloc>
+	void load(int fd, ft::vector<T, Alloc>& vec)
+	{
+		snapshot::fdSource source(fd);
+		snapshot::readVector(source, vec);
+	}
+
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void save(std::ostream& out, const ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		snapshot::streamSink sink(out);
+		mapSnapshot<ft::map<Key, T, Compare, Alloc> >::write(sink, mp);
+	}
+
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void save(int fd, const ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		snapshot::fdSink sink(fd);
+		mapSnapshot<ft::map<Key, T, Compare, Alloc> >::write(sink, mp);
+	}
+
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void load(std::istream& in, ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		snapshot::streamSource source(in);
+		mapSnapshot<ft::map<Key, T, Compare, Alloc> >::read(source, mp);
+	}
+
+	template<typename Key, typename T, typename Compare, typename Alloc>
+	void load(int fd, ft::map<Key, T, Compare, Alloc>& mp)
+	{
+		snapshot::fdSource source(fd);
+		mapSnapshot<ft::map<Key, T, Compare, Alloc> >::read(source, mp);
+	}
+}
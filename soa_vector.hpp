@@ -0,0 +1,307 @@
+#pragma once
+
+#if __cplusplus < 201103L
+	#error "soa_vector.hpp requires C++11 (variadic templates and std::tuple)"
+#endif
+
+#include <memory>
+#include <tuple>
+#include <stdexcept>
+#include "vector.hpp"
+#include "span.hpp"
+
+namespace ft
+{
+	template<size_t... Indexes>
+	struct indexSequence { };
+
+	template<size_t N, size_t... Indexes>
+	struct makeIndexSequence
+		: makeIndexSequence<N - 1, N - 1, Indexes...> { };
+
+	template<size_t... Indexes>
+	struct makeIndexSequence<0, Indexes...>
+	{
+		typedef indexSequence<Indexes...> type;
+	};
+
+	template<typename... Fields>
+	class soa_vector
+	{
+		static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+
+	public:
+		typedef std::tuple<Fields...>								value_type;
+		typedef size_t												size_type;
+		typedef typename makeIndexSequence<sizeof...(Fields)>::type	indexes;
+
+		template<size_t I>
+		struct field
+		{
+			typedef typename std::tuple_element<I, value_type>::type type;
+		};
+
+		// proxy for one row: reads and writes go straight to the columns
+		template<typename Owner>
+		class rowProxy
+		{
+		public:
+			rowProxy(Owner& owner, size_t idx)
+				: owner(owner), idx(idx) { }
+
+			template<size_t I>
+			typename std::conditional<std::is_const<Owner>::value,
+									const typename field<I>::type&,
+									typename field<I>::type&>::type get() const
+			{
+				return std::get<I>(owner.columns).vectorBaseVar.start[idx];
+			}
+
+			operator value_type() const
+			{
+				return owner.loadRow(idx, indexes());
+			}
+
+			const rowProxy& operator=(const value_type& values) const
+			{
+				owner.storeRow(idx, values, indexes());
+				return *this;
+			}
+
+			const rowProxy& operator=(const rowProxy& rhs) const
+			{
+				return *this = static_cast<value_type>(rhs);
+			}
+
+		private:
+			Owner&	owner;
+			size_t	idx;
+		};
+
+		typedef rowProxy<soa_vector>		reference;
+		typedef rowProxy<const soa_vector>	const_reference;
+
+	private:
+		std::tuple<ft::vectorBase<Fields>...>	columns;
+
+		template<typename Owner>
+		friend class rowProxy;
+
+	public:
+		soa_vector()
+			: columns() { }
+
+		soa_vector(const soa_vector& x)
+			: columns()
+		{
+			reserve(x.size());
+			for (size_t i = 0; i < x.size(); i++)
+				push_back(x.loadRow(i, indexes()));
+		}
+
+		~soa_vector()
+		{
+			destroyColumns(indexes());
+		}
+
+		soa_vector& operator=(const soa_vector& rhs)
+		{
+			if (this == &rhs)
+				return *this;
+			soa_vector temp(rhs);
+			swap(temp);
+			return *this;
+		}
+
+		size_type size() const
+		{
+			return std::get<0>(columns).vectorBaseVar.finish - std::get<0>(columns).vectorBaseVar.start;
+		}
+
+		size_type capacity() const
+		{
+			return std::get<0>(columns).vectorBaseVar.endOfStorage - std::get<0>(columns).vectorBaseVar.start;
+		}
+
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		void reserve(size_type n)
+		{
+			if (n > capacity())
+				growColumns(n, indexes());
+		}
+
+		void push_back(const Fields&... values)
+		{
+			push_back(value_type(values...));
+		}
+
+		void push_back(const value_type& values)
+		{
+			if (size() == capacity())
+				growColumns(size() ? 2 * size() : 1, indexes());
+			constructRow(values, indexes());
+		}
+
+		void pop_back()
+		{
+			popColumns(indexes());
+		}
+
+		void clear()
+		{
+			while (!empty())
+				pop_back();
+		}
+
+		void swap(soa_vector& x)
+		{
+			swapColumns(x, indexes());
+		}
+
+		reference operator[](size_type idx)
+		{
+			return reference(*this, idx);
+		}
+
+		const_reference operator[](size_type idx) const
+		{
+			return const_reference(*this, idx);
+		}
+
+		reference at(size_type idx)
+		{
+			if (idx >= size())
+				throw std::out_of_range("soa_vector::at out of range");
+			return (*this)[idx];
+		}
+
+		const_reference at(size_type idx) const
+		{
+			if (idx >= size())
+				throw std::out_of_range("soa_vector::at out of range");
+			return (*this)[idx];
+		}
+
+		// one field as a contiguous span, iterated with vectorIterator so the
+		// contiguous overloads (ft::equal, ft::parallel, ...) apply to it
+		template<size_t I>
+		ft::span<typename field<I>::type> column()
+		{
+			return ft::span<typename field<I>::type>(std::get<I>(columns).vectorBaseVar.start, size());
+		}
+
+		template<size_t I>
+		ft::span<const typename field<I>::type> column() const
+		{
+			return ft::span<const typename field<I>::type>(std::get<I>(columns).vectorBaseVar.start, size());
+		}
+
+	private:
+		// gives the empty column to storage for n elements and copies from into it
+		template<typename T>
+		static void copyColumn(const ft::vectorBase<T>& from, ft::vectorBase<T>& to, size_t n)
+		{
+			ft::vectorBase<T> temp(n);
+			temp.swapData(to.vectorBaseVar);
+			to.vectorBaseVar.finish = std::uninitialized_copy(from.vectorBaseVar.start, from.vectorBaseVar.finish, to.vectorBaseVar.start);
+		}
+
+		template<typename T>
+		static void destroyColumn(ft::vectorBase<T>& column)
+		{
+			std::allocator<T> alloc;
+			for (T* elem = column.vectorBaseVar.start; elem != column.vectorBaseVar.finish; ++elem)
+				alloc.destroy(elem);
+		}
+
+		template<typename T>
+		static void popColumn(ft::vectorBase<T>& column)
+		{
+			std::allocator<T>().destroy(--column.vectorBaseVar.finish);
+		}
+
+		// element I of the row being built lives one past the end of its column
+		template<size_t I>
+		void constructField(const value_type& values)
+		{
+			::new (static_cast<void*>(std::get<I>(columns).vectorBaseVar.finish)) typename field<I>::type(std::get<I>(values));
+		}
+
+		template<size_t I>
+		void destroyField()
+		{
+			std::allocator<typename field<I>::type>().destroy(std::get<I>(columns).vectorBaseVar.finish);
+		}
+
+		// growth mirrors ft::vector, for all columns at once: every column is
+		// copied into a new soa_vector before any of them is replaced, so a
+		// failed allocation or copy leaves the columns as they were
+		template<size_t... I>
+		void growColumns(size_t n, indexSequence<I...>)
+		{
+			soa_vector grown;
+			int expand[] = { 0, (copyColumn(std::get<I>(columns), std::get<I>(grown.columns), n), 0)... };
+			(void)expand;
+			swap(grown);
+		}
+
+		template<size_t... I>
+		void destroyColumns(indexSequence<I...>)
+		{
+			int expand[] = { 0, (destroyColumn(std::get<I>(columns)), 0)... };
+			(void)expand;
+		}
+
+		template<size_t... I>
+		void popColumns(indexSequence<I...>)
+		{
+			int expand[] = { 0, (popColumn(std::get<I>(columns)), 0)... };
+			(void)expand;
+		}
+
+		template<size_t... I>
+		void swapColumns(soa_vector& x, indexSequence<I...>)
+		{
+			int expand[] = { 0, (std::get<I>(columns).swapData(std::get<I>(x.columns).vectorBaseVar), 0)... };
+			(void)expand;
+		}
+
+		// the row only becomes part of the columns once every field has been
+		// built; a throwing field constructor destroys the fields before it
+		template<size_t... I>
+		void constructRow(const value_type& values, indexSequence<I...>)
+		{
+			size_t built = 0;
+			try
+			{
+				int expand[] = { 0, (constructField<I>(values), ++built, 0)... };
+				(void)expand;
+			}
+			catch (...)
+			{
+				int unwind[] = { 0, (I < built ? destroyField<I>() : void(), 0)... };
+				(void)unwind;
+				throw;
+			}
+			int expand[] = { 0, (++std::get<I>(columns).vectorBaseVar.finish, 0)... };
+			(void)expand;
+		}
+
+		template<size_t... I>
+		void storeRow(size_t idx, const value_type& values, indexSequence<I...>)
+		{
+			int expand[] = { 0, (std::get<I>(columns).vectorBaseVar.start[idx] = std::get<I>(values), 0)... };
+			(void)expand;
+		}
+
+		template<size_t... I>
+		value_type loadRow(size_t idx, indexSequence<I...>) const
+		{
+			return value_type(std::get<I>(columns).vectorBaseVar.start[idx]...);
+		}
+	};
+}
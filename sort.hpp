@@ -0,0 +1,871 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <utility>
+#include "iterator.hpp"
+#include "utils.hpp"
+
+namespace ft
+{
+	/********************	 RADIX KEYS	 *********************/
+
+	// the key radix_sort(first, last) sorts by: integral elements are their
+	// own key, ft::pair elements with an integral first are keyed by first
+	template<typename T, typename Enable = void>
+	struct radixKey
+	{
+		static const bool value = false;
+	};
+
+	template<typename T>
+	struct radixKey<T, typename ft::enable_if<ft::is_integral<T>::value>::type>
+	{
+		static const bool value = true;
+		typedef T type;
+
+		type operator()(const T& elem) const
+		{
+			return elem;
+		}
+	};
+
+	template<typename K, typename V>
+	struct radixKey<ft::pair<K, V>, typename ft::enable_if<ft::is_integral<K>::value>::type>
+	{
+		static const bool value = true;
+		typedef K type;
+
+		type operator()(const ft::pair<K, V>& elem) const
+		{
+			return elem.first;
+		}
+	};
+
+	namespace radix
+	{
+		// below this many elements the histograms cost more than they save
+		static const size_t insertionThreshold = 64;
+
+		template<typename T>
+		struct bareType
+		{
+			typedef T type;
+		};
+
+		template<typename T>
+		struct bareType<const T>
+		{
+			typedef T type;
+		};
+
+		template<typename T>
+		struct bareType<T&>
+		{
+			typedef typename bareType<T>::type type;
+		};
+
+#if __cplusplus >= 201103L
+		template<typename T>
+		struct bareType<T&&>
+		{
+			typedef typename bareType<T>::type type;
+		};
+
+		// integral type a key extractor returns for an element of the range,
+		// whatever it is: function, functor or lambda
+		template<typename KeyExtractor, typename RandomAccessIterator>
+		struct extractorResult
+		{
+			typedef typename bareType<decltype(std::declval<KeyExtractor&>()(*std::declval<RandomAccessIterator&>()))>::type type;
+		};
+#else
+		// integral type a key extractor returns: result_type for functors (as
+		// std::unary_function declares it), the return type for functions
+		template<typename KeyExtractor, typename RandomAccessIterator>
+		struct extractorResult
+		{
+			typedef typename bareType<typename KeyExtractor::result_type>::type type;
+		};
+
+		template<typename R, typename A, typename RandomAccessIterator>
+		struct extractorResult<R (*)(A), RandomAccessIterator>
+		{
+			typedef typename bareType<R>::type type;
+		};
+#endif
+
+		// the key as an unsigned number of its own width with the same order:
+		// signed keys get their sign bit flipped so that negative keys come first
+		template<typename Key>
+		inline unsigned long long ordered(Key key)
+		{
+			unsigned long long bits = static_cast<unsigned long long>(key);
+			if (sizeof(Key) < sizeof(bits))
+				bits &= (1ULL << (sizeof(Key) * 8 % 64)) - 1;
+			if (std::numeric_limits<Key>::is_signed)
+				bits ^= 1ULL << (sizeof(Key) * 8 - 1);
+			return bits;
+		}
+
+		template<typename Key, typename RandomAccessIterator, typename KeyExtractor>
+		void insertionSort(RandomAccessIterator first, RandomAccessIterator last, KeyExtractor key)
+		{
+			typedef typename ft::iterator_traits<RandomAccessIterator>::value_type value_type;
+
+			for (RandomAccessIterator it = first + 1; it < last; ++it)
+			{
+				value_type moving = *it;
+				unsigned long long bits = ordered<Key>(key(moving));
+				RandomAccessIterator hole = it;
+				for (; hole != first && bits < ordered<Key>(key(*(hole - 1))); --hole)
+					*hole = *(hole - 1);
+				*hole = moving;
+			}
+		}
+
+		// one counting-sort pass on the byte at shift; offsets holds the first
+		// output slot of every byte value and is advanced while scattering
+		template<typename Key, typename InputIterator, typename OutputIterator, typename KeyExtractor>
+		void scatter(InputIterator first, InputIterator last, OutputIterator out, size_t* offsets, unsigned shift, KeyExtractor key)
+		{
+			for (; first != last; ++first)
+				out[offsets[(ordered<Key>(key(*first)) >> shift) & 0xFF]++] = *first;
+		}
+
+		// LSD byte-wise sort. All byte histograms are built in one read pass;
+		// bytes every key shares are skipped, the others ping-pong between the
+		// range and one scratch buffer. Stable, O(n * bytes that differ)
+		template<typename Key, typename RandomAccessIterator, typename KeyExtractor>
+		void sortBy(RandomAccessIterator first, RandomAccessIterator last, KeyExtractor key)
+		{
+			typedef typename ft::iterator_traits<RandomAccessIterator>::value_type value_type;
+
+			size_t n = last - first;
+			if (n < 2)
+				return;
+			if (n < insertionThreshold)
+			{
+				insertionSort<Key>(first, last, key);
+				return;
+			}
+			size_t counts[sizeof(Key)][256];
+			for (size_t b = 0; b < sizeof(Key); b++)
+				std::fill(counts[b], counts[b] + 256, 0);
+			for (RandomAccessIterator it = first; it != last; ++it)
+			{
+				unsigned long long bits = ordered<Key>(key(*it));
+				for (size_t b = 0; b < sizeof(Key); b++)
+					++counts[b][(bits >> (8 * b)) & 0xFF];
+			}
+			unsigned long long sample = ordered<Key>(key(*first));
+
+			std::allocator<value_type> alloc;
+			value_type* buffer = NULL;
+			bool inBuffer = false;
+			try
+			{
+				for (size_t b = 0; b < sizeof(Key); b++)
+				{
+					size_t* offsets = counts[b];
+					if (offsets[(sample >> (8 * b)) & 0xFF] == n)
+						continue;
+					if (buffer == NULL)
+					{
+						buffer = alloc.allocate(n);
+						try
+						{
+							std::uninitialized_copy(first, last, buffer);
+						}
+						catch (...)
+						{
+							alloc.deallocate(buffer, n);
+							buffer = NULL;
+							throw;
+						}
+					}
+					size_t sum = 0;
+					for (size_t v = 0; v < 256; v++)
+					{
+						size_t count = offsets[v];
+						offsets[v] = sum;
+						sum += count;
+					}
+					if (inBuffer)
+						scatter<Key>(buffer, buffer + n, first, offsets, 8 * b, key);
+					else
+						scatter<Key>(first, last, buffer, offsets, 8 * b, key);
+					inBuffer = !inBuffer;
+				}
+				if (inBuffer)
+					std::copy(buffer, buffer + n, first);
+			}
+			catch (...)
+			{
+				if (buffer != NULL)
+				{
+					for (size_t i = 0; i < n; i++)
+						alloc.destroy(buffer + i);
+					alloc.deallocate(buffer, n);
+				}
+				throw;
+			}
+			if (buffer != NULL)
+			{
+				for (size_t i = 0; i < n; i++)
+					alloc.destroy(buffer + i);
+				alloc.deallocate(buffer, n);
+			}
+		}
+	}
+
+	/********************	 RADIX SORT	 *********************/
+
+	// sorts integral elements, or ft::pair elements by an integral first
+	template<typename RandomAccessIterator>
+	typename ft::enable_if<radixKey<typename ft::iterator_traits<RandomAccessIterator>::value_type>::value>::type
+	radix_sort(RandomAccessIterator first, RandomAccessIterator last)
+	{
+		typedef radixKey<typename ft::iterator_traits<RandomAccessIterator>::value_type> keyType;
+
+		radix::sortBy<typename keyType::type>(first, last, keyType());
+	}
+
+	// sorts by the integral key(elem); before C++11, key is a function or a
+	// functor with a result_type typedef
+	template<typename RandomAccessIterator, typename KeyExtractor>
+	void radix_sort(RandomAccessIterator first, RandomAccessIterator last, KeyExtractor key)
+	{
+		radix::sortBy<typename radix::extractorResult<KeyExtractor, RandomAccessIterator>::type>(first, last, key);
+	}
+
+	namespace pdq
+	{
+		static const size_t insertionSortThreshold = 24;
+		static const size_t nintherThreshold = 128;
+		static const size_t partialInsertionSortLimit = 8;
+		static const size_t blockSize = 64;
+		static const size_t cachelineSize = 64;
+
+		template<typename T>
+		struct isArithmetic : public ft::integral_constant<bool, ft::is_integral<T>::value> {};
+
+		template<>
+		struct isArithmetic<float> : public ft::true_type {};
+
+		template<>
+		struct isArithmetic<double> : public ft::true_type {};
+
+		template<>
+		struct isArithmetic<long double> : public ft::true_type {};
+
+		// comparisons that compile to one flag-setting instruction, so the
+		// block partition can turn them into offsets without branching
+		template<typename T, typename Compare>
+		struct branchlessCompare : public ft::false_type {};
+
+		template<typename T>
+		struct branchlessCompare<T, std::less<T> > : public ft::integral_constant<bool, isArithmetic<T>::value> {};
+
+		template<typename T>
+		struct branchlessCompare<T, std::greater<T> > : public ft::integral_constant<bool, isArithmetic<T>::value> {};
+
+		template<typename Iterator, typename Compare>
+		inline void sort2(Iterator a, Iterator b, Compare comp)
+		{
+			if (comp(*b, *a))
+				std::iter_swap(a, b);
+		}
+
+		template<typename Iterator, typename Compare>
+		inline void sort3(Iterator a, Iterator b, Iterator c, Compare comp)
+		{
+			sort2(a, b, comp);
+			sort2(b, c, comp);
+			sort2(a, b, comp);
+		}
+
+		template<typename Iterator, typename Compare>
+		void insertionSort(Iterator begin, Iterator end, Compare comp)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			if (begin == end)
+				return;
+			for (Iterator cur = begin + 1; cur != end; ++cur)
+			{
+				Iterator sift = cur;
+				Iterator before = cur - 1;
+				if (comp(*sift, *before))
+				{
+					value_type moving = *sift;
+					do
+						*sift-- = *before;
+					while (sift != begin && comp(moving, *--before));
+					*sift = moving;
+				}
+			}
+		}
+
+		// the element before begin is not greater than any in the range and
+		// stops the sift, so the bounds check can go
+		template<typename Iterator, typename Compare>
+		void unguardedInsertionSort(Iterator begin, Iterator end, Compare comp)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			if (begin == end)
+				return;
+			for (Iterator cur = begin + 1; cur != end; ++cur)
+			{
+				Iterator sift = cur;
+				Iterator before = cur - 1;
+				if (comp(*sift, *before))
+				{
+					value_type moving = *sift;
+					do
+						*sift-- = *before;
+					while (comp(moving, *--before));
+					*sift = moving;
+				}
+			}
+		}
+
+		// insertion sort that gives up after partialInsertionSortLimit moves;
+		// true when the range ended up sorted
+		template<typename Iterator, typename Compare>
+		bool partialInsertionSort(Iterator begin, Iterator end, Compare comp)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			if (begin == end)
+				return true;
+			size_t moves = 0;
+			for (Iterator cur = begin + 1; cur != end; ++cur)
+			{
+				Iterator sift = cur;
+				Iterator before = cur - 1;
+				if (comp(*sift, *before))
+				{
+					value_type moving = *sift;
+					do
+						*sift-- = *before;
+					while (sift != begin && comp(moving, *--before));
+					*sift = moving;
+					moves += cur - sift;
+				}
+				if (moves > partialInsertionSortLimit)
+					return false;
+			}
+			return true;
+		}
+
+		inline unsigned char* alignCacheline(unsigned char* storage)
+		{
+			size_t address = reinterpret_cast<size_t>(storage);
+			address = (address + cachelineSize - 1) & ~(cachelineSize - 1);
+			return reinterpret_cast<unsigned char*>(address);
+		}
+
+		// swaps the misplaced elements found on both sides; with an unequal
+		// count a cyclic permutation needs fewer moves than swaps
+		template<typename Iterator>
+		void swapOffsets(Iterator first, Iterator last, unsigned char* offsetsLeft, unsigned char* offsetsRight, size_t num, bool useSwaps)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			if (useSwaps)
+			{
+				for (size_t i = 0; i < num; ++i)
+					std::iter_swap(first + offsetsLeft[i], last - offsetsRight[i]);
+			}
+			else if (num > 0)
+			{
+				Iterator left = first + offsetsLeft[0];
+				Iterator right = last - offsetsRight[0];
+				value_type saved = *left;
+				*left = *right;
+				for (size_t i = 1; i < num; ++i)
+				{
+					left = first + offsetsLeft[i];
+					*right = *left;
+					right = last - offsetsRight[i];
+					*left = *right;
+				}
+				*right = saved;
+			}
+		}
+
+		// partitions around *begin: [begin, pivot) < pivot <= (pivot, end).
+		// The second member is true when nothing had to be swapped
+		template<typename Iterator, typename Compare>
+		ft::pair<Iterator, bool> partitionRight(Iterator begin, Iterator end, Compare comp, ft::false_type)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			value_type pivot = *begin;
+			Iterator first = begin;
+			Iterator last = end;
+			while (comp(*++first, pivot))
+				;
+			// the median of three left an element >= pivot at the end unless
+			// the loop above did not move
+			if (first - 1 == begin)
+				while (first < last && !comp(*--last, pivot))
+					;
+			else
+				while (!comp(*--last, pivot))
+					;
+			bool alreadyPartitioned = first >= last;
+			while (first < last)
+			{
+				std::iter_swap(first, last);
+				while (comp(*++first, pivot))
+					;
+				while (!comp(*--last, pivot))
+					;
+			}
+			Iterator pivotPosition = first - 1;
+			*begin = *pivotPosition;
+			*pivotPosition = pivot;
+			return ft::make_pair(pivotPosition, alreadyPartitioned);
+		}
+
+		// block partition (BlockQuicksort, Edelkamp and Weiss): comparisons
+		// only record offsets, the swaps happen afterwards in bulk, so no
+		// branch depends on the outcome of a comparison
+		template<typename Iterator, typename Compare>
+		ft::pair<Iterator, bool> partitionRight(Iterator begin, Iterator end, Compare comp, ft::true_type)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			value_type pivot = *begin;
+			Iterator first = begin;
+			Iterator last = end;
+			while (comp(*++first, pivot))
+				;
+			if (first - 1 == begin)
+				while (first < last && !comp(*--last, pivot))
+					;
+			else
+				while (!comp(*--last, pivot))
+					;
+			bool alreadyPartitioned = first >= last;
+			if (!alreadyPartitioned)
+			{
+				std::iter_swap(first, last);
+				++first;
+
+				unsigned char offsetsLeftStorage[blockSize + cachelineSize];
+				unsigned char offsetsRightStorage[blockSize + cachelineSize];
+				unsigned char* offsetsLeft = alignCacheline(offsetsLeftStorage);
+				unsigned char* offsetsRight = alignCacheline(offsetsRightStorage);
+				Iterator offsetsLeftBase = first;
+				Iterator offsetsRightBase = last;
+				size_t numLeft = 0;
+				size_t numRight = 0;
+				size_t startLeft = 0;
+				size_t startRight = 0;
+				while (first < last)
+				{
+					// fill whichever offset buffer ran empty, splitting what is
+					// left between both sides near the end
+					size_t numUnknown = last - first;
+					size_t leftSplit = numLeft == 0 ? (numRight == 0 ? numUnknown / 2 : numUnknown) : 0;
+					size_t rightSplit = numRight == 0 ? (numUnknown - leftSplit) : 0;
+					if (leftSplit >= blockSize)
+						leftSplit = blockSize;
+					if (rightSplit >= blockSize)
+						rightSplit = blockSize;
+					for (size_t i = 0; i < leftSplit; ++i)
+					{
+						offsetsLeft[numLeft] = static_cast<unsigned char>(i);
+						numLeft += !comp(*first, pivot);
+						++first;
+					}
+					for (size_t i = 0; i < rightSplit;)
+					{
+						offsetsRight[numRight] = static_cast<unsigned char>(++i);
+						numRight += comp(*--last, pivot);
+					}
+					size_t num = numLeft < numRight ? numLeft : numRight;
+					swapOffsets(offsetsLeftBase, offsetsRightBase, offsetsLeft + startLeft, offsetsRight + startRight, num, numLeft == numRight);
+					numLeft -= num;
+					numRight -= num;
+					startLeft += num;
+					startRight += num;
+					if (numLeft == 0)
+					{
+						startLeft = 0;
+						offsetsLeftBase = first;
+					}
+					if (numRight == 0)
+					{
+						startRight = 0;
+						offsetsRightBase = last;
+					}
+				}
+				// one side may still hold misplaced elements: move them to the
+				// middle
+				if (numLeft)
+				{
+					offsetsLeft += startLeft;
+					while (numLeft--)
+						std::iter_swap(offsetsLeftBase + offsetsLeft[numLeft], --last);
+					first = last;
+				}
+				if (numRight)
+				{
+					offsetsRight += startRight;
+					while (numRight--)
+					{
+						std::iter_swap(offsetsRightBase - offsetsRight[numRight], first);
+						++first;
+					}
+				}
+			}
+			Iterator pivotPosition = first - 1;
+			*begin = *pivotPosition;
+			*pivotPosition = pivot;
+			return ft::make_pair(pivotPosition, alreadyPartitioned);
+		}
+
+		// used when the pivot equals the element before the range: everything
+		// equal to it goes left, [begin, pivot] <= pivot < (pivot, end)
+		template<typename Iterator, typename Compare>
+		Iterator partitionLeft(Iterator begin, Iterator end, Compare comp)
+		{
+			typedef typename ft::iterator_traits<Iterator>::value_type value_type;
+
+			value_type pivot = *begin;
+			Iterator first = begin;
+			Iterator last = end;
+			while (comp(pivot, *--last))
+				;
+			if (last + 1 == end)
+				while (first < last && !comp(pivot, *++first))
+					;
+			else
+				while (!comp(pivot, *++first))
+					;
+			while (first < last)
+			{
+				std::iter_swap(first, last);
+				while (comp(pivot, *--last))
+					;
+				while (!comp(pivot, *++first))
+					;
+			}
+			Iterator pivotPosition = last;
+			*begin = *pivotPosition;
+			*pivotPosition = pivot;
+			return pivotPosition;
+		}
+
+		template<typename Iterator, typename Compare>
+		void heapSort(Iterator begin, Iterator end, Compare comp)
+		{
+			std::make_heap(begin, end, comp);
+			std::sort_heap(begin, end, comp);
+		}
+
+		// swaps a few elements around so the next pivot choices differ from
+		// the pattern that produced an unbalanced partition
+		template<typename Iterator>
+		void breakPatterns(Iterator begin, Iterator pivotPosition, Iterator end)
+		{
+			size_t leftSize = pivotPosition - begin;
+			size_t rightSize = end - (pivotPosition + 1);
+			if (leftSize >= insertionSortThreshold)
+			{
+				std::iter_swap(begin, begin + leftSize / 4);
+				std::iter_swap(pivotPosition - 1, pivotPosition - leftSize / 4);
+				if (leftSize > nintherThreshold)
+				{
+					std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+					std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+					std::iter_swap(pivotPosition - 2, pivotPosition - (leftSize / 4 + 1));
+					std::iter_swap(pivotPosition - 3, pivotPosition - (leftSize / 4 + 2));
+				}
+			}
+			if (rightSize >= insertionSortThreshold)
+			{
+				std::iter_swap(pivotPosition + 1, pivotPosition + (1 + rightSize / 4));
+				std::iter_swap(end - 1, end - rightSize / 4);
+				if (rightSize > nintherThreshold)
+				{
+					std::iter_swap(pivotPosition + 2, pivotPosition + (2 + rightSize / 4));
+					std::iter_swap(pivotPosition + 3, pivotPosition + (3 + rightSize / 4));
+					std::iter_swap(end - 2, end - (1 + rightSize / 4));
+					std::iter_swap(end - 3, end - (2 + rightSize / 4));
+				}
+			}
+		}
+
+		// recurses into the left part and loops on the right one. After
+		// badAllowed unbalanced partitions the range is heap sorted, which
+		// keeps the worst case at O(n log n)
+		template<typename Iterator, typename Compare, typename Branchless>
+		void sortLoop(Iterator begin, Iterator end, Compare comp, int badAllowed, bool leftmost, Branchless branchless)
+		{
+			while (true)
+			{
+				size_t size = end - begin;
+				if (size < insertionSortThreshold)
+				{
+					if (leftmost)
+						insertionSort(begin, end, comp);
+					else
+						unguardedInsertionSort(begin, end, comp);
+					return;
+				}
+				// median of three, or pseudo median of nine on large ranges
+				size_t half = size / 2;
+				if (size > nintherThreshold)
+				{
+					sort3(begin, begin + half, end - 1, comp);
+					sort3(begin + 1, begin + (half - 1), end - 2, comp);
+					sort3(begin + 2, begin + (half + 1), end - 3, comp);
+					sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+					std::iter_swap(begin, begin + half);
+				}
+				else
+					sort3(begin + half, begin, end - 1, comp);
+				// a pivot equal to the element before the range: the equal
+				// elements are put in place at once, this handles many duplicates
+				if (!leftmost && !comp(*(begin - 1), *begin))
+				{
+					begin = partitionLeft(begin, end, comp) + 1;
+					continue;
+				}
+				ft::pair<Iterator, bool> partition = partitionRight(begin, end, comp, branchless);
+				Iterator pivotPosition = partition.first;
+				size_t leftSize = pivotPosition - begin;
+				size_t rightSize = end - (pivotPosition + 1);
+				if (leftSize < size / 8 || rightSize < size / 8)
+				{
+					if (--badAllowed == 0)
+					{
+						heapSort(begin, end, comp);
+						return;
+					}
+					breakPatterns(begin, pivotPosition, end);
+				}
+				// nothing moved: the input may already be sorted
+				else if (partition.second && partialInsertionSort(begin, pivotPosition, comp)
+							&& partialInsertionSort(pivotPosition + 1, end, comp))
+					return;
+				sortLoop(begin, pivotPosition, comp, badAllowed, leftmost, branchless);
+				begin = pivotPosition + 1;
+				leftmost = false;
+			}
+		}
+
+		inline int log2(size_t n)
+		{
+			int log = 0;
+			while (n >>= 1)
+				++log;
+			return log;
+		}
+	}
+
+	/********************	 SORT	 *********************/
+
+	// pattern-defeating quicksort (Orson Peters): introsort with a block
+	// partition for arithmetic keys under std::less/std::greater, and
+	// O(n) on ranges that are already sorted or sorted in reverse
+	template<typename RandomAccessIterator, typename Compare>
+	void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+	{
+		typedef typename ft::iterator_traits<RandomAccessIterator>::value_type value_type;
+
+		size_t n = last - first;
+		if (n < 2)
+			return;
+		RandomAccessIterator run = first + 1;
+		while (run != last && !comp(*run, *(run - 1)))
+			++run;
+		if (run == last)
+			return;
+		// a strictly descending range only needs reversing
+		if (run == first + 1)
+		{
+			while (run != last && comp(*run, *(run - 1)))
+				++run;
+			if (run == last)
+			{
+				std::reverse(first, last);
+				return;
+			}
+		}
+		pdq::sortLoop(first, last, comp, pdq::log2(n), true, pdq::branchlessCompare<value_type, Compare>());
+	}
+
+	template<typename RandomAccessIterator>
+	void sort(RandomAccessIterator first, RandomAccessIterator last)
+	{
+		ft::sort(first, last, std::less<typename ft::iterator_traits<RandomAccessIterator>::value_type>());
+	}
+
+	namespace mergeSort
+	{
+		static const size_t insertionSortThreshold = 32;
+
+		template<typename Iterator, typename Compare>
+		void insertionSort(Iterator begin, Iterator end, Compare comp)
+		{
+			pdq::insertionSort(begin, end, comp);
+		}
+
+		// merges the sorted runs [first, middle) and [middle, last) with the
+		// left run moved out to buffer; equal elements keep their order
+		template<typename Iterator, typename Pointer, typename Compare>
+		void mergeWithBuffer(Iterator first, Iterator middle, Iterator last, Pointer buffer, Compare comp)
+		{
+			Pointer bufferEnd = std::copy(first, middle, buffer);
+			Iterator out = first;
+			while (buffer != bufferEnd && middle != last)
+			{
+				if (comp(*middle, *buffer))
+					*out++ = *middle++;
+				else
+					*out++ = *buffer++;
+			}
+			std::copy(buffer, bufferEnd, out);
+		}
+
+		// rotation based merge for when no buffer could be allocated:
+		// O(n log n) moves instead of O(n)
+		template<typename Iterator, typename Compare>
+		void mergeWithoutBuffer(Iterator first, Iterator middle, Iterator last, size_t leftSize, size_t rightSize, Compare comp)
+		{
+			if (leftSize == 0 || rightSize == 0)
+				return;
+			if (leftSize + rightSize == 2)
+			{
+				if (comp(*middle, *first))
+					std::iter_swap(first, middle);
+				return;
+			}
+			Iterator firstCut;
+			Iterator secondCut;
+			size_t firstHalf;
+			size_t secondHalf;
+			if (leftSize > rightSize)
+			{
+				firstHalf = leftSize / 2;
+				firstCut = first + firstHalf;
+				secondCut = std::lower_bound(middle, last, *firstCut, comp);
+				secondHalf = secondCut - middle;
+			}
+			else
+			{
+				secondHalf = rightSize / 2;
+				secondCut = middle + secondHalf;
+				firstCut = std::upper_bound(first, middle, *secondCut, comp);
+				firstHalf = firstCut - first;
+			}
+			std::rotate(firstCut, middle, secondCut);
+			Iterator newMiddle = firstCut + secondHalf;
+			mergeWithoutBuffer(first, firstCut, newMiddle, firstHalf, secondHalf, comp);
+			mergeWithoutBuffer(newMiddle, secondCut, last, leftSize - firstHalf, rightSize - secondHalf, comp);
+		}
+
+		// top-down merge sort; halves that are already in order are not merged,
+		// so sorted input costs one comparison per run. buffer is NULL when
+		// none could be allocated, otherwise it holds (n + 1) / 2 elements
+		template<typename Iterator, typename Pointer, typename Compare>
+		void sortRange(Iterator first, Iterator last, Pointer buffer, Compare comp)
+		{
+			size_t n = last - first;
+			if (n <= insertionSortThreshold)
+			{
+				insertionSort(first, last, comp);
+				return;
+			}
+			Iterator middle = first + (n + 1) / 2;
+			sortRange(first, middle, buffer, comp);
+			sortRange(middle, last, buffer, comp);
+			if (!comp(*middle, *(middle - 1)))
+				return;
+			if (buffer != NULL)
+				mergeWithBuffer(first, middle, last, buffer, comp);
+			else
+				mergeWithoutBuffer(first, middle, last, middle - first, last - middle, comp);
+		}
+	}
+
+	/********************	 STABLE SORT	 *********************/
+
+	// adaptive merge sort: merges through a buffer of half the range when it
+	// can be allocated and in place otherwise. Equal elements keep their order
+	template<typename RandomAccessIterator, typename Compare>
+	void stable_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+	{
+		typedef typename ft::iterator_traits<RandomAccessIterator>::value_type value_type;
+
+		size_t n = last - first;
+		if (n < 2)
+			return;
+		// strictly descending has no equal neighbours to keep in order
+		RandomAccessIterator run = first + 1;
+		while (run != last && comp(*run, *(run - 1)))
+			++run;
+		if (run == last)
+		{
+			std::reverse(first, last);
+			return;
+		}
+		if (n <= mergeSort::insertionSortThreshold)
+		{
+			mergeSort::insertionSort(first, last, comp);
+			return;
+		}
+		std::allocator<value_type> alloc;
+		size_t bufferSize = (n + 1) / 2;
+		value_type* buffer = NULL;
+		try
+		{
+			buffer = alloc.allocate(bufferSize);
+		}
+		catch (std::bad_alloc&)
+		{
+			mergeSort::sortRange(first, last, buffer, comp);
+			return;
+		}
+		try
+		{
+			std::uninitialized_copy(first, first + bufferSize, buffer);
+		}
+		catch (...)
+		{
+			alloc.deallocate(buffer, bufferSize);
+			throw;
+		}
+		try
+		{
+			mergeSort::sortRange(first, last, buffer, comp);
+		}
+		catch (...)
+		{
+			for (size_t i = 0; i < bufferSize; i++)
+				alloc.destroy(buffer + i);
+			alloc.deallocate(buffer, bufferSize);
+			throw;
+		}
+		for (size_t i = 0; i < bufferSize; i++)
+			alloc.destroy(buffer + i);
+		alloc.deallocate(buffer, bufferSize);
+	}
+
+	template<typename RandomAccessIterator>
+	void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+	{
+		ft::stable_sort(first, last, std::less<typename ft::iterator_traits<RandomAccessIterator>::value_type>());
+	}
+}
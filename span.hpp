@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// Non-owning view over contiguous storage: a pointer and a length.
+	// The viewed elements must outlive the span; any reallocation of the
+	// underlying ft::vector invalidates it like an iterator.
+	template<typename T>
+	class span
+	{
+	public:
+		typedef T												element_type;
+		typedef typename ft::remove_const<T>::type				value_type;
+		typedef T&												reference;
+		typedef T*												pointer;
+		typedef size_t											size_type;
+		typedef ptrdiff_t										difference_type;
+		typedef ft::vectorIterator<T*>							iterator;
+		typedef ft::reverse_iterator<iterator>					reverse_iterator;
+
+		static const size_type npos = static_cast<size_type>(-1);
+
+	private:
+		pointer		ptr;
+		size_type	count;
+
+	public:
+		span() throw()
+			: ptr(NULL), count(0) { }
+
+		span(pointer first, size_type count) throw()
+			: ptr(first), count(count) { }
+
+		// a template so that span(p, 0) still picks the (pointer, count) form
+		template<typename U>
+		span(U* first, U* last) throw()
+			: ptr(first), count(last - first) { }
+
+		template<typename Pointer>
+		span(ft::vectorIterator<Pointer> first, ft::vectorIterator<Pointer> last) throw()
+			: ptr(first.base()), count(last - first) { }
+
+		template<size_t N>
+		span(element_type (&arr)[N]) throw()
+			: ptr(arr), count(N) { }
+
+		template<typename Allocator>
+		span(ft::vector<value_type, Allocator>& vec) throw()
+			: ptr(vec.data()), count(vec.size()) { }
+
+		// only usable by span<const T>
+		template<typename Allocator>
+		span(const ft::vector<value_type, Allocator>& vec) throw()
+			: ptr(vec.data()), count(vec.size()) { }
+
+		// span<T> to span<const T>
+		template<typename U>
+		span(const span<U>& other) throw()
+			: ptr(other.data()), count(other.size()) { }
+
+	// ITERATORS //
+
+		iterator begin() const throw() { return iterator(ptr); }
+		iterator end() const throw() { return iterator(ptr + count); }
+		reverse_iterator rbegin() const throw() { return reverse_iterator(end()); }
+		reverse_iterator rend() const throw() { return reverse_iterator(begin()); }
+
+	// ELEMENT ACCESS //
+
+		pointer data() const throw() { return ptr; }
+		reference operator[](size_type idx) const throw() { return ptr[idx]; }
+		reference front() const throw() { return ptr[0]; }
+		reference back() const throw() { return ptr[count - 1]; }
+
+		reference at(size_type idx) const
+		{
+			if (idx >= count)
+				throw std::out_of_range("span::at out of range");
+			return ptr[idx];
+		}
+
+	// OBSERVERS //
+
+		size_type size() const throw() { return count; }
+		size_type size_bytes() const throw() { return count * sizeof(element_type); }
+		bool empty() const throw() { return count == 0; }
+
+	// SUBVIEWS //
+
+		span first(size_type n) const
+		{
+			if (n > count)
+				throw std::out_of_range("span::first out of range");
+			return span(ptr, n);
+		}
+
+		span last(size_type n) const
+		{
+			if (n > count)
+				throw std::out_of_range("span::last out of range");
+			return span(ptr + (count - n), n);
+		}
+
+		span subspan(size_type offset, size_type n = npos) const
+		{
+			if (offset > count || (n != npos && n > count - offset))
+				throw std::out_of_range("span::subspan out of range");
+			return span(ptr + offset, n == npos ? count - offset : n);
+		}
+	};
+
+	template<typename T>
+	const typename span<T>::size_type span<T>::npos;
+
+	template<typename T>
+	inline span<T> make_span(T* first, size_t count)
+	{
+		return span<T>(first, count);
+	}
+
+	template<typename T>
+	inline span<T> make_span(T* first, T* last)
+	{
+		return span<T>(first, last);
+	}
+
+	template<typename T, typename Allocator>
+	inline span<T> make_span(ft::vector<T, Allocator>& vec)
+	{
+		return span<T>(vec);
+	}
+
+	template<typename T, typename Allocator>
+	inline span<const T> make_span(const ft::vector<T, Allocator>& vec)
+	{
+		return span<const T>(vec);
+	}
+
+	// whole-range forms of the algorithms, so spans go through the
+	// contiguous (SIMD) overloads without spelling out the iterators
+	template<typename T, typename U>
+	inline bool equal(const span<T>& lhs, const span<U>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template<typename T, typename U>
+	inline bool lexicographical_compare(const span<T>& lhs, const span<U>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+}
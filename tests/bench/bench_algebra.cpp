@@ -0,0 +1,130 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../map_algebra.hpp"
+
+#ifndef LARGE
+	#define LARGE 10000000
+#endif
+#define SMALL 100000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::map<int, int>	intMap;
+
+// what we did before: walk the maps and insert the survivors one by one.
+// Inserting them in key order would degenerate the unbalanced tree into a
+// list, so they are shuffled first, which is what made this usable at all
+intMap	naive(const intMap& a, const intMap& b, int op)
+{
+	ft::vector<ft::pair<int, int> > survivors;
+	for (intMap::const_iterator it = a.begin(); it != a.end(); ++it)
+		if (op == 0 || (op == 1) == (b.count(it->first) == 1))
+			survivors.push_back(*it);
+	if (op == 0)
+		for (intMap::const_iterator it = b.begin(); it != b.end(); ++it)
+			if (a.count(it->first) == 0)
+				survivors.push_back(*it);
+	for (size_t i = survivors.size(); i > 1; i--)
+	{
+		size_t j = rand() % i;
+		ft::pair<int, int> tmp = survivors[i - 1];
+		survivors[i - 1] = survivors[j];
+		survivors[j] = tmp;
+	}
+	intMap result;
+	for (size_t i = 0; i < survivors.size(); i++)
+		result.insert(survivors[i]);
+	return result;
+}
+
+// the results go straight into out: out = map_union(a, b) would copy them
+void	algebra(const intMap& a, const intMap& b, int op, intMap& out)
+{
+	if (op == 0)
+		ft::map_union(a, b, out);
+	else if (op == 1)
+		ft::map_intersection(a, b, out);
+	else
+		ft::map_difference(a, b, out);
+}
+
+void	algebraParallel(const intMap& a, const intMap& b, int op, intMap& out)
+{
+	if (op == 0)
+		ft::map_union(a, b, ft::parallel::options(), out);
+	else if (op == 1)
+		ft::map_intersection(a, b, ft::parallel::options(), out);
+	else
+		ft::map_difference(a, b, ft::parallel::options(), out);
+}
+
+void	algebraConsume(intMap a, intMap b, int op, intMap& out, double& elapsed)
+{
+	double start = nowMs();
+	if (op == 0)
+		ft::map_union(a, b, ft::consume, out);
+	else if (op == 1)
+		ft::map_intersection(a, b, ft::consume, out);
+	else
+		ft::map_difference(a, b, ft::consume, out);
+	elapsed = nowMs() - start;
+}
+
+int main()
+{
+	srand(42);
+	intMap large;
+	intMap small;
+	while (large.size() < LARGE)
+		large.insert(ft::make_pair(rand(), 0));
+	// half of the small keys are in the large map, picked in random order:
+	// inserting them sorted would turn the unbalanced tree into a list
+	while (small.size() < SMALL / 2)
+		small.insert(*large.select(rand() % LARGE));
+	while (small.size() < SMALL)
+		small.insert(ft::make_pair(rand(), 1));
+
+	const char* ops[] = { "union", "intersection", "difference" };
+	// intersection and difference are also run with the small map first
+	const intMap* firsts[] = { &large, &large, &small };
+	const intMap* seconds[] = { &small, &small, &large };
+	std::cout << LARGE << " and " << SMALL << " keys, times in ms (" << std::thread::hardware_concurrency() << " threads)" << std::endl;
+	std::cout << std::setw(14) << "operation" << std::setw(10) << "result" << std::setw(10) << "naive"
+		<< std::setw(10) << "ft" << std::setw(10) << "parallel" << std::setw(10) << "consume" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	for (int op = 0; op < 3; op++)
+	{
+		const intMap& a = *firsts[op];
+		const intMap& b = *seconds[op];
+		double times[4];
+		double start = nowMs();
+		intMap expected = naive(a, b, op);
+		times[0] = nowMs() - start;
+		intMap serial, parallel, consumed;
+		start = nowMs();
+		algebra(a, b, op, serial);
+		times[1] = nowMs() - start;
+		start = nowMs();
+		algebraParallel(a, b, op, parallel);
+		times[2] = nowMs() - start;
+		algebraConsume(a, b, op, consumed, times[3]);
+		if (serial != expected || parallel != expected || consumed != expected)
+		{
+			std::cerr << "bench_algebra: " << ops[op] << " differs from the naive result" << std::endl;
+			return (1);
+		}
+		std::cout << std::setw(14) << ops[op] << std::setw(10) << expected.size();
+		for (int i = 0; i < 4; i++)
+			std::cout << std::setw(10) << times[i];
+		std::cout << std::endl;
+	}
+	return (0);
+}
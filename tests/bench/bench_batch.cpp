@@ -0,0 +1,74 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../map.hpp"
+#include "../../vector.hpp"
+
+// the largest map, well past the last-level cache (about 48 bytes a node)
+#ifndef MAX_ELEMENTS
+	#define MAX_ELEMENTS 6400000
+#endif
+
+#define LOOKUPS 1000000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+int	randomInt()
+{
+	return ((rand() << 15) ^ rand());
+}
+
+typedef ft::map<int, int>	intMap;
+
+int main()
+{
+	srand(42);
+	std::cout << "times in ms for " << LOOKUPS << " random lookups, half of them misses" << std::endl;
+	std::cout << std::setw(12) << "map size" << std::setw(14) << "find loop" << std::setw(14) << "find_batch"
+		<< std::setw(10) << "speedup" << std::endl;
+	for (size_t n = 100000; n <= MAX_ELEMENTS; n *= 4)
+	{
+		// random insertion order keeps the unbalanced tree shallow
+		intMap mp;
+		ft::vector<int> present;
+		while (mp.size() < n)
+		{
+			int k = randomInt() & ~1;
+			if (mp.insert(ft::make_pair(k, k)).second)
+				present.push_back(k);
+		}
+		ft::vector<int> keys;
+		for (size_t i = 0; i < LOOKUPS; i++)
+			keys.push_back(i % 2 ? present[randomInt() % present.size()] : randomInt() | 1);
+		ft::vector<intMap::iterator> serial(LOOKUPS);
+		ft::vector<intMap::iterator> batched(LOOKUPS);
+		// warm-up, so both runs start with the same cache contents
+		mp.find_batch(&keys[0], LOOKUPS, &batched[0]);
+
+		double start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+			serial[i] = mp.find(keys[i]);
+		double serialTime = nowMs() - start;
+		start = nowMs();
+		mp.find_batch(&keys[0], LOOKUPS, &batched[0]);
+		double batchTime = nowMs() - start;
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			if (serial[i] != batched[i])
+			{
+				std::cerr << "bench_batch: find_batch disagrees with find for key " << keys[i] << std::endl;
+				return (1);
+			}
+		}
+		std::cout << std::setw(12) << n << std::fixed << std::setprecision(2) << std::setw(14) << serialTime
+			<< std::setw(14) << batchTime << std::setw(9) << serialTime / batchTime << "x" << std::endl;
+	}
+	return (0);
+}
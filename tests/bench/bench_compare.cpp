@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <time.h>
+#include "../../vector.hpp"
+
+#define MAX_BYTES (64 * 1024 * 1024)
+#define BYTES_PER_SIZE (128 * 1024 * 1024L)
+
+double	nowNs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+// keeps the compiler from hoisting the comparison out of the timing loop
+inline void	clobber()
+{
+	__asm__ __volatile__("" : : : "memory");
+}
+
+// element-wise loop, the code path used before the contiguous overloads
+template<typename T>
+bool scalarEqual(const ft::vector<T>& lhs, const ft::vector<T>& rhs)
+{
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T>
+bool scalarLess(const ft::vector<T>& lhs, const ft::vector<T>& rhs)
+{
+	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename T>
+void	benchType(const char* name)
+{
+	std::cout << std::endl << name << std::endl;
+	std::cout << std::setw(10) << "bytes"
+		<< std::setw(14) << "scalar ==" << std::setw(14) << "ft ==" << std::setw(10) << "GB/s"
+		<< std::setw(14) << "scalar <" << std::setw(14) << "ft <" << std::setw(10) << "GB/s" << std::endl;
+	for (long bytes = 16; bytes <= MAX_BYTES; bytes *= 4)
+	{
+		size_t n = bytes / sizeof(T);
+		ft::vector<T> lhs(n, T());
+		for (size_t i = 0; i < n; i++)
+			lhs[i] = static_cast<T>(rand());
+		ft::vector<T> same(lhs);
+		ft::vector<T> rhs(lhs);
+		// equal inputs force a full scan, the last element decides the ordering
+		rhs[n - 1] = static_cast<T>(rhs[n - 1] + 1);
+		long reps = BYTES_PER_SIZE / bytes;
+		long hits[4] = {0, 0, 0, 0};
+		double elapsed[4];
+		double start;
+
+		start = nowNs();
+		for (long r = 0; r < reps; r++)
+		{
+			clobber();
+			hits[0] += scalarEqual(lhs, same);
+		}
+		elapsed[0] = (nowNs() - start) / reps;
+		start = nowNs();
+		for (long r = 0; r < reps; r++)
+		{
+			clobber();
+			hits[1] += (lhs == same);
+		}
+		elapsed[1] = (nowNs() - start) / reps;
+		start = nowNs();
+		for (long r = 0; r < reps; r++)
+		{
+			clobber();
+			hits[2] += scalarLess(lhs, rhs);
+		}
+		elapsed[2] = (nowNs() - start) / reps;
+		start = nowNs();
+		for (long r = 0; r < reps; r++)
+		{
+			clobber();
+			hits[3] += (lhs < rhs);
+		}
+		elapsed[3] = (nowNs() - start) / reps;
+		if (hits[0] != hits[1] || hits[2] != hits[3])
+		{
+			std::cerr << "bench_compare: result mismatch at " << bytes << " bytes" << std::endl;
+			exit(1);
+		}
+		std::cout << std::setw(10) << bytes << std::fixed << std::setprecision(1)
+			<< std::setw(12) << elapsed[0] << "ns" << std::setw(12) << elapsed[1] << "ns"
+			<< std::setw(10) << std::setprecision(2) << bytes / elapsed[1] << std::setprecision(1)
+			<< std::setw(12) << elapsed[2] << "ns" << std::setw(12) << elapsed[3] << "ns"
+			<< std::setw(10) << std::setprecision(2) << bytes / elapsed[3] << std::endl;
+	}
+}
+
+int main()
+{
+	srand(42);
+	benchType<char>("ft::vector<char>");
+	benchType<unsigned char>("ft::vector<unsigned char>");
+	benchType<int>("ft::vector<int>");
+	benchType<long>("ft::vector<long>");
+	return (0);
+}
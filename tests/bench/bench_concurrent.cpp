@@ -0,0 +1,180 @@
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include "../../map.hpp"
+#include "../../concurrent_map.hpp"
+
+#ifndef KEYS
+	#define KEYS 100000
+#endif
+
+#ifndef RUN_MS
+	#define RUN_MS 500
+#endif
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+int	randomInt()
+{
+	return ((rand() << 15) ^ rand());
+}
+
+// what readers do today: every lookup takes the writer's mutex
+class lockedMap
+{
+public:
+	class reader
+	{
+	public:
+		explicit reader(lockedMap& owner)
+			: owner(owner) { }
+
+		bool find(int k, int& value) const
+		{
+			std::lock_guard<std::mutex> hold(owner.lock);
+			ft::map<int, int>::iterator it = owner.mp.find(k);
+			if (it == owner.mp.end())
+				return false;
+			value = it->second;
+			return true;
+		}
+
+	private:
+		lockedMap&	owner;
+	};
+
+	bool insert_or_assign(const ft::pair<const int, int>& val)
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		mp[val.first] = val.second;
+		return true;
+	}
+
+	size_t erase(int k)
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		return mp.erase(k);
+	}
+
+private:
+	std::mutex			lock;
+	ft::map<int, int>	mp;
+};
+
+typedef ft::concurrent_map<int, int>	concurrentMap;
+
+struct runResult
+{
+	double	lookups;	// per second, all readers together
+	double	writes;		// per second
+	long	wrong;
+};
+
+// Every key maps to 3 * key. The writer keeps erasing and putting back
+// the odd keys, and replacing the even ones, so readers must always find
+// those with the right value.
+template<typename Table>
+runResult run(const ft::vector<int>& keys, unsigned readerCount)
+{
+	Table table;
+	for (size_t i = 0; i < keys.size(); i++)
+		table.insert_or_assign(ft::make_pair(keys[i], keys[i] * 3));
+	std::atomic<bool> stop(false);
+	std::atomic<long> lookups(0);
+	std::atomic<long> wrong(0);
+	std::vector<std::thread> readers;
+	for (unsigned t = 0; t < readerCount; t++)
+		readers.push_back(std::thread([&table, &keys, &stop, &lookups, &wrong, t]()
+		{
+			typename Table::reader r(table);
+			unsigned state = t + 1;
+			long done = 0;
+			long bad = 0;
+			int value;
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				for (int i = 0; i < 256; i++)
+				{
+					state = state * 1103515245 + 12345;
+					int k = keys[(state >> 8) % keys.size()];
+					if (r.find(k, value) ? value != k * 3 : k % 2 == 0)
+						++bad;
+				}
+				done += 256;
+			}
+			lookups += done;
+			wrong += bad;
+		}));
+	long writes = 0;
+	unsigned state = 7;
+	double start = nowMs();
+	while (nowMs() - start < RUN_MS)
+	{
+		for (int i = 0; i < 64; i++)
+		{
+			state = state * 1103515245 + 12345;
+			int k = keys[(state >> 8) % keys.size()];
+			if (k % 2 == 0 || (state >> 4) % 2)
+				table.insert_or_assign(ft::make_pair(k, k * 3));
+			else
+				table.erase(k);
+		}
+		writes += 64;
+	}
+	stop.store(true);
+	for (size_t t = 0; t < readers.size(); t++)
+		readers[t].join();
+	double seconds = (nowMs() - start) / 1e3;
+	runResult result = { lookups.load() / seconds, writes / seconds, wrong.load() };
+	return result;
+}
+
+int main()
+{
+	srand(42);
+	// random insertion order keeps the unbalanced tree shallow
+	ft::vector<int> keys;
+	{
+		ft::map<int, int> unique;
+		while (unique.size() < KEYS)
+		{
+			int k = randomInt() % (KEYS * 16);
+			if (unique.insert(ft::make_pair(k, 0)).second)
+				keys.push_back(k);
+		}
+	}
+	unsigned maxReaders = std::thread::hardware_concurrency();
+	if (maxReaders < 4)
+		maxReaders = 4;
+	std::cout << KEYS << " keys, one writer replacing and erasing keys without pause, " << RUN_MS
+		<< " ms per run" << std::endl;
+	std::cout << "millions of lookups (all readers) and writes per second" << std::endl;
+	std::cout << std::setw(8) << "readers" << std::setw(16) << "mutex reads" << std::setw(16) << "mutex writes"
+		<< std::setw(16) << "lockfree reads" << std::setw(16) << "lockfree writes" << std::setw(10) << "speedup" << std::endl;
+	for (unsigned readers = 1; readers <= maxReaders; readers *= 2)
+	{
+		runResult locked = run<lockedMap>(keys, readers);
+		runResult lockFree = run<concurrentMap>(keys, readers);
+		if (locked.wrong || lockFree.wrong)
+		{
+			std::cerr << "bench_concurrent: a reader saw a missing key or a wrong value" << std::endl;
+			return (1);
+		}
+		std::cout << std::setw(8) << readers << std::fixed << std::setprecision(2)
+			<< std::setw(16) << locked.lookups / 1e6 << std::setw(16) << locked.writes / 1e6
+			<< std::setw(16) << lockFree.lookups / 1e6 << std::setw(16) << lockFree.writes / 1e6
+			<< std::setw(9) << lockFree.lookups / locked.lookups << "x" << std::endl;
+	}
+	return (0);
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../vector.hpp"
+#include "../../cow_vector.hpp"
+
+#define ELEMENTS (1 << 20)
+#define SNAPSHOTS 2000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+// a reader only looks at a few elements of the snapshot it was handed
+template<typename Container>
+long	consume(const Container& snapshot, int i)
+{
+	return snapshot[i % snapshot.size()] + snapshot[(i * 7919) % snapshot.size()];
+}
+
+// the two ways to write an element: cow_vector::operator[] marks the buffer
+// unshareable, so every later snapshot is a full copy; set() does not
+struct writeIndexed
+{
+	template<typename Container, typename T>
+	void	operator()(Container& live, size_t idx, const T& val) const
+	{
+		live[idx] = val;
+	}
+};
+
+struct writeSet
+{
+	template<typename T>
+	void	operator()(ft::cow_vector<T>& live, size_t idx, const T& val) const
+	{
+		live.set(idx, val);
+	}
+};
+
+// every writeEvery-th snapshot is followed by a write to the live container
+template<typename Container, typename Writer>
+double	snapshotWorkload(Container& live, int writeEvery, Writer writeAt, long& checksum)
+{
+	double start = nowMs();
+	for (int i = 0; i < SNAPSHOTS; i++)
+	{
+		Container snapshot(live);
+		checksum += consume(snapshot, i);
+		if (writeEvery && i % writeEvery == 0)
+			writeAt(live, i % live.size(), i);
+	}
+	return nowMs() - start;
+}
+
+int main()
+{
+	srand(42);
+	ft::vector<int> plain;
+	for (int i = 0; i < ELEMENTS; i++)
+		plain.push_back(rand());
+	ft::cow_vector<int> cowSet(plain);
+	ft::cow_vector<int> cowIndexed(plain);
+
+	std::cout << SNAPSHOTS << " snapshots of " << ELEMENTS << " ints, times in ms; cow_vector written with set() and operator[]" << std::endl;
+	std::cout << std::setw(14) << "writes" << std::setw(14) << "ft::vector" << std::setw(14) << "cow set()" << std::setw(10) << "speedup"
+		<< std::setw(14) << "cow []" << std::setw(10) << "speedup" << std::endl;
+	int writeRatios[] = {0, 100, 10, 1};
+	for (int r = 0; r < 4; r++)
+	{
+		long plainSum = 0;
+		long setSum = 0;
+		long indexedSum = 0;
+		double plainTime = snapshotWorkload(plain, writeRatios[r], writeIndexed(), plainSum);
+		double setTime = snapshotWorkload(cowSet, writeRatios[r], writeSet(), setSum);
+		double indexedTime = snapshotWorkload(cowIndexed, writeRatios[r], writeIndexed(), indexedSum);
+		if (plainSum != setSum || plainSum != indexedSum)
+		{
+			std::cerr << "bench_cow: checksums differ" << std::endl;
+			return (1);
+		}
+		if (writeRatios[r])
+			std::cout << std::setw(12) << "1/" << std::left << std::setw(2) << writeRatios[r] << std::right;
+		else
+			std::cout << std::setw(14) << "none";
+		std::cout << std::fixed << std::setprecision(2) << std::setw(14) << plainTime
+			<< std::setw(14) << setTime << std::setw(9) << plainTime / setTime << "x"
+			<< std::setw(14) << indexedTime << std::setw(9) << plainTime / indexedTime << "x" << std::endl;
+	}
+	return (0);
+}
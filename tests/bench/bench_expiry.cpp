@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <cstdlib>
+#include <time.h>
+#include "../../map.hpp"
+
+#define ELEMENTS (1 << 20)
+#define WINDOWS 10
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::map<int, int>	ftMap;
+typedef std::map<int, int>	stdMap;
+
+// the cutoff of the w-th expiry window: every window drops a tenth of the key space
+int	cutoff(int w)
+{
+	return RAND_MAX / WINDOWS * (w + 1);
+}
+
+// what map::erase(first, last) used to do: one bst::erase per element
+double	expireOneByOne(ftMap m)
+{
+	double start = nowMs();
+	for (int w = 0; w < WINDOWS; w++)
+	{
+		ftMap::iterator last = m.lower_bound(cutoff(w));
+		for (ftMap::iterator it = m.begin(); it != last; )
+			m.erase(it++);
+	}
+	return nowMs() - start;
+}
+
+template<typename Map>
+double	expireRange(Map m)
+{
+	double start = nowMs();
+	for (int w = 0; w < WINDOWS; w++)
+		m.erase(m.begin(), m.lower_bound(cutoff(w)));
+	return nowMs() - start;
+}
+
+double	expireExtract(ftMap m, long& moved)
+{
+	ftMap window;
+	double start = nowMs();
+	for (int w = 0; w < WINDOWS; w++)
+	{
+		m.extract_range(w ? cutoff(w - 1) : 0, cutoff(w), window);
+		moved += window.size();
+	}
+	return nowMs() - start;
+}
+
+int main()
+{
+	srand(42);
+	ftMap ftKeys;
+	stdMap stdKeys;
+	while (ftKeys.size() < ELEMENTS)
+	{
+		int key = rand();
+		ftKeys.insert(ft::make_pair(key, key));
+		stdKeys.insert(std::make_pair(key, key));
+	}
+
+	long moved = 0;
+	double times[4];
+	times[0] = expireOneByOne(ftKeys);
+	times[1] = expireRange(ftKeys);
+	times[2] = expireExtract(ftKeys, moved);
+	times[3] = expireRange(stdKeys);
+	if (moved != static_cast<long>(ftKeys.size()))
+	{
+		std::cerr << "bench_expiry: extract_range moved " << moved << " of " << ftKeys.size() << " elements" << std::endl;
+		return (1);
+	}
+
+	const char* names[4] = { "ft one by one", "ft erase range", "ft extract_range", "std erase range" };
+	std::cout << ELEMENTS << " keys expired in " << WINDOWS << " windows, times in ms" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	for (int i = 0; i < 4; i++)
+		std::cout << std::setw(18) << names[i] << std::setw(10) << times[i] << std::endl;
+	return (0);
+}
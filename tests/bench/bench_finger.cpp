@@ -0,0 +1,76 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+#include "../../map.hpp"
+#include "../../vector.hpp"
+
+#define ELEMENTS 1000000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::map<int, int>	intMap;
+
+int main()
+{
+	srand(42);
+	// random insertion order keeps the unbalanced tree at logarithmic height
+	ft::vector<int> keys;
+	for (int i = 0; i < ELEMENTS; i++)
+		keys.push_back(i * 2);
+	std::random_shuffle(keys.begin(), keys.end());
+	intMap m;
+	for (int i = 0; i < ELEMENTS; i++)
+		m.insert(ft::make_pair(keys[i], i));
+
+	std::cout << ELEMENTS << " keys, ascending batches (half of the probes missing), times in ms" << std::endl;
+	std::cout << std::setw(10) << "batch" << std::setw(12) << "find" << std::setw(14) << "find_sorted" << std::setw(10) << "speedup"
+		<< std::setw(14) << "lower_bound" << std::setw(12) << "_sorted" << std::setw(10) << "speedup" << std::endl;
+	for (int batch = 1000; batch <= ELEMENTS; batch *= 10)
+	{
+		// every (2 * ELEMENTS / batch)-th key of the whole key range, odd
+		// probes are missing
+		ft::vector<int> probes;
+		int step = 2 * ELEMENTS / batch;
+		for (int i = 0; i < batch; i++)
+			probes.push_back(i * step + (i & 1));
+		ft::vector<intMap::iterator> single(batch);
+		ft::vector<intMap::iterator> sorted(batch);
+		double times[4];
+		double start = nowMs();
+		for (int i = 0; i < batch; i++)
+			single[i] = m.find(probes[i]);
+		times[0] = nowMs() - start;
+		start = nowMs();
+		m.find_sorted(probes.begin(), probes.end(), sorted.begin());
+		times[1] = nowMs() - start;
+		if (single != sorted)
+		{
+			std::cerr << "bench_finger: find_sorted disagrees with find" << std::endl;
+			return (1);
+		}
+		start = nowMs();
+		for (int i = 0; i < batch; i++)
+			single[i] = m.lower_bound(probes[i]);
+		times[2] = nowMs() - start;
+		start = nowMs();
+		m.lower_bound_sorted(probes.begin(), probes.end(), sorted.begin());
+		times[3] = nowMs() - start;
+		if (single != sorted)
+		{
+			std::cerr << "bench_finger: lower_bound_sorted disagrees with lower_bound" << std::endl;
+			return (1);
+		}
+		std::cout << std::fixed << std::setprecision(2) << std::setw(10) << batch << std::setw(12) << times[0] << std::setw(14) << times[1]
+			<< std::setw(9) << times[0] / times[1] << "x" << std::setw(14) << times[2] << std::setw(12) << times[3]
+			<< std::setw(9) << times[2] / times[3] << "x" << std::endl;
+	}
+	return (0);
+}
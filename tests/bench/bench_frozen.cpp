@@ -0,0 +1,127 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../map.hpp"
+#include "../../vector.hpp"
+
+#ifndef MAX_ELEMENTS
+	#define MAX_ELEMENTS 4096000
+#endif
+
+#define LOOKUPS 2000000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+int	randomInt()
+{
+	return ((rand() << 15) ^ rand());
+}
+
+typedef ft::map<int, int>			intMap;
+typedef ft::frozen_map<int, int>	frozenMap;
+
+void	printRow(const char* name, size_t n, double mapTime, double frozenTime)
+{
+	std::cout << std::setw(14) << name << std::setw(12) << n << std::fixed << std::setprecision(2)
+		<< std::setw(12) << mapTime << std::setw(12) << frozenTime << std::setw(9) << mapTime / frozenTime << "x" << std::endl;
+}
+
+int main()
+{
+	srand(42);
+	std::cout << "times in ms for " << LOOKUPS << " random lookups, half of them misses" << std::endl;
+	std::cout << std::setw(14) << "operation" << std::setw(12) << "n" << std::setw(12) << "map" << std::setw(12) << "frozen_map"
+		<< std::setw(10) << "speedup" << std::endl;
+	for (size_t n = 1000; n <= MAX_ELEMENTS; n *= 4)
+	{
+		// random insertion order keeps the unbalanced tree shallow
+		intMap mp;
+		ft::vector<int> present;
+		while (mp.size() < n)
+		{
+			int k = randomInt() & ~1;
+			if (mp.insert(ft::make_pair(k, k)).second)
+				present.push_back(k);
+		}
+		ft::vector<int> keys;
+		for (size_t i = 0; i < LOOKUPS; i++)
+			keys.push_back(i % 2 ? present[randomInt() % present.size()] : randomInt() | 1);
+		frozenMap frozen = mp.freeze();
+
+		// the sums keep the loops from being optimised away and check the results
+		long long mapSum = 0;
+		long long frozenSum = 0;
+		double start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			intMap::iterator it = mp.find(keys[i]);
+			if (it != mp.end())
+				mapSum += it->second;
+		}
+		double mapTime = nowMs() - start;
+		start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			frozenMap::const_iterator it = frozen.find(keys[i]);
+			if (it != frozen.end())
+				frozenSum += it->second;
+		}
+		double frozenTime = nowMs() - start;
+		if (mapSum != frozenSum)
+		{
+			std::cerr << "bench_frozen: find results differ" << std::endl;
+			return (1);
+		}
+		printRow("find", n, mapTime, frozenTime);
+
+		mapSum = 0;
+		frozenSum = 0;
+		start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			intMap::iterator it = mp.lower_bound(keys[i]);
+			if (it != mp.end())
+				mapSum += it->first;
+		}
+		mapTime = nowMs() - start;
+		start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			frozenMap::const_iterator it = frozen.lower_bound(keys[i]);
+			if (it != frozen.end())
+				frozenSum += it->first;
+		}
+		frozenTime = nowMs() - start;
+		if (mapSum != frozenSum)
+		{
+			std::cerr << "bench_frozen: lower_bound results differ" << std::endl;
+			return (1);
+		}
+		printRow("lower_bound", n, mapTime, frozenTime);
+
+		mapSum = 0;
+		frozenSum = 0;
+		start = nowMs();
+		for (intMap::iterator it = mp.begin(); it != mp.end(); ++it)
+			mapSum += it->second;
+		mapTime = nowMs() - start;
+		start = nowMs();
+		for (frozenMap::const_iterator it = frozen.begin(); it != frozen.end(); ++it)
+			frozenSum += it->second;
+		frozenTime = nowMs() - start;
+		if (mapSum != frozenSum)
+		{
+			std::cerr << "bench_frozen: iteration results differ" << std::endl;
+			return (1);
+		}
+		printRow("iteration", n, mapTime, frozenTime);
+	}
+	return (0);
+}
@@ -0,0 +1,146 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <unistd.h>
+#include "../../map.hpp"
+#include "../../vector.hpp"
+#include "../../snapshot.hpp"
+#include "../../mapped_map.hpp"
+
+#ifndef MAX_ELEMENTS
+	#define MAX_ELEMENTS 4096000
+#endif
+
+#define LOOKUPS 1000000
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+int	randomInt()
+{
+	return ((rand() << 15) ^ rand());
+}
+
+typedef ft::map<int, int>			intMap;
+typedef ft::mapped_map<int, int>	mappedMap;
+
+void	printRow(const char* name, size_t n, double mapTime, double mappedTime)
+{
+	std::cout << std::setw(14) << name << std::setw(12) << n << std::fixed << std::setprecision(3)
+		<< std::setw(12) << mapTime << std::setw(12) << mappedTime << std::setw(11) << std::setprecision(1)
+		<< mapTime / mappedTime << "x" << std::endl;
+}
+
+int main()
+{
+	srand(42);
+	std::cout << "times in ms: opening a saved table (a snapshot loaded into an ft::map, or a mapped_map),"
+		" then " << LOOKUPS << " random lookups, half of them misses" << std::endl;
+	std::cout << std::setw(14) << "operation" << std::setw(12) << "n" << std::setw(12) << "map" << std::setw(12) << "mapped_map"
+		<< std::setw(12) << "speedup" << std::endl;
+	char snapshotPath[] = "/tmp/bench_mapped_snapshot_XXXXXX";
+	char mappedPath[] = "/tmp/bench_mapped_table_XXXXXX";
+	int snapshotFd = mkstemp(snapshotPath);
+	int mappedFd = mkstemp(mappedPath);
+	if (snapshotFd < 0 || mappedFd < 0)
+	{
+		std::cerr << "bench_mapped: mkstemp failed" << std::endl;
+		return (1);
+	}
+	close(snapshotFd);
+	close(mappedFd);
+	int status = 0;
+	for (size_t n = 1000; n <= MAX_ELEMENTS && status == 0; n *= 4)
+	{
+		// random insertion order keeps the unbalanced tree shallow
+		intMap mp;
+		ft::vector<int> present;
+		while (mp.size() < n)
+		{
+			int k = randomInt() & ~1;
+			if (mp.insert(ft::make_pair(k, k / 3)).second)
+				present.push_back(k);
+		}
+		ft::vector<int> keys;
+		for (size_t i = 0; i < LOOKUPS; i++)
+			keys.push_back(i % 2 ? present[randomInt() % present.size()] : randomInt() | 1);
+		FILE* snapshotFile = fopen(snapshotPath, "w");
+		ft::save(fileno(snapshotFile), mp);
+		fclose(snapshotFile);
+		ft::save_mapped(mappedPath, mp);
+		mp.clear();
+
+		// the files were just written, so both opens read from the page cache
+		double start = nowMs();
+		intMap loaded;
+		FILE* in = fopen(snapshotPath, "r");
+		ft::load(fileno(in), loaded);
+		fclose(in);
+		double mapTime = nowMs() - start;
+		start = nowMs();
+		mappedMap table(mappedPath);
+		double mappedTime = nowMs() - start;
+		if (loaded.size() != n || table.size() != n)
+		{
+			std::cerr << "bench_mapped: sizes differ" << std::endl;
+			status = 1;
+			break;
+		}
+		printRow("open", n, mapTime, mappedTime);
+
+		// the sums keep the loops from being optimised away and check the results
+		long long mapSum = 0;
+		long long mappedSum = 0;
+		start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			intMap::iterator it = loaded.find(keys[i]);
+			if (it != loaded.end())
+				mapSum += it->second;
+		}
+		mapTime = nowMs() - start;
+		start = nowMs();
+		for (size_t i = 0; i < LOOKUPS; i++)
+		{
+			mappedMap::const_iterator it = table.find(keys[i]);
+			if (it != table.end())
+				mappedSum += it->second;
+		}
+		mappedTime = nowMs() - start;
+		if (mapSum != mappedSum)
+		{
+			std::cerr << "bench_mapped: find results differ" << std::endl;
+			status = 1;
+			break;
+		}
+		printRow("find", n, mapTime, mappedTime);
+
+		mapSum = 0;
+		mappedSum = 0;
+		start = nowMs();
+		for (intMap::iterator it = loaded.begin(); it != loaded.end(); ++it)
+			mapSum += it->second;
+		mapTime = nowMs() - start;
+		start = nowMs();
+		for (mappedMap::const_iterator it = table.begin(); it != table.end(); ++it)
+			mappedSum += it->second;
+		mappedTime = nowMs() - start;
+		if (mapSum != mappedSum)
+		{
+			std::cerr << "bench_mapped: iteration results differ" << std::endl;
+			status = 1;
+			break;
+		}
+		printRow("iteration", n, mapTime, mappedTime);
+	}
+	unlink(snapshotPath);
+	unlink(mappedPath);
+	return (status);
+}
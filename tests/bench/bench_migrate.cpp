@@ -0,0 +1,106 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <cstdlib>
+#include <time.h>
+#include "../../map.hpp"
+
+#define ELEMENTS (1 << 18)
+#define MIGRATIONS (ELEMENTS * 4 + ELEMENTS / 2)
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::map<int, long>	ftMap;
+typedef std::map<int, long>	stdMap;
+
+int	keyPool[ELEMENTS];
+
+// keys are drawn from a fixed pool so every migration finds its entry in one of the two maps
+int	pickKey(int i)
+{
+	return keyPool[i % ELEMENTS];
+}
+
+// copy-in, erase-out: what moving an entry cost before node handles
+template<typename Map>
+double	migrateByCopy(Map& pending, Map& active)
+{
+	double start = nowMs();
+	for (int i = 0; i < MIGRATIONS; i++)
+	{
+		int key = pickKey(i);
+		Map& from = pending.count(key) ? pending : active;
+		Map& to = (&from == &pending) ? active : pending;
+		typename Map::iterator it = from.find(key);
+		to.insert(*it);
+		from.erase(it);
+	}
+	return nowMs() - start;
+}
+
+double	migrateByHandle(ftMap& pending, ftMap& active)
+{
+	double start = nowMs();
+	for (int i = 0; i < MIGRATIONS; i++)
+	{
+		int key = pickKey(i);
+		ftMap& from = pending.count(key) ? pending : active;
+		ftMap& to = (&from == &pending) ? active : pending;
+		to.insert(from.extract(key));
+	}
+	return nowMs() - start;
+}
+
+template<typename Map>
+void	fill(Map& pending)
+{
+	for (int i = 0; i < ELEMENTS; i++)
+		pending.insert(typename Map::value_type(keyPool[i], i));
+}
+
+int main()
+{
+	srand(42);
+	for (int i = 0; i < ELEMENTS; i++)
+		keyPool[i] = rand();
+	ftMap ftPending, ftActive, handlePending, handleActive;
+	stdMap stdPending, stdActive;
+	fill(ftPending);
+	fill(handlePending);
+	fill(stdPending);
+
+	double times[4];
+	times[0] = migrateByCopy(ftPending, ftActive);
+	times[1] = migrateByHandle(handlePending, handleActive);
+	times[2] = migrateByCopy(stdPending, stdActive);
+	if (ftActive.size() != stdActive.size() || handleActive.size() != stdActive.size())
+	{
+		std::cerr << "bench_migrate: maps disagree after migration" << std::endl;
+		return (1);
+	}
+
+	// merge everything back: relinks the nodes, no allocation
+	double start = nowMs();
+	handlePending.merge(handleActive);
+	times[3] = nowMs() - start;
+	if (handlePending.size() != stdPending.size() + stdActive.size() || !handleActive.empty())
+	{
+		std::cerr << "bench_migrate: merge lost elements" << std::endl;
+		return (1);
+	}
+
+	const char* names[3] = { "ft copy + erase", "ft extract/insert", "std copy + erase" };
+	std::cout << MIGRATIONS << " migrations between two maps of " << ELEMENTS << " keys" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	for (int i = 0; i < 3; i++)
+		std::cout << std::setw(20) << names[i] << std::setw(10) << times[i] << " ms"
+			<< std::setw(12) << MIGRATIONS / times[i] / 1e3 << " M/s" << std::endl;
+	std::cout << std::setw(20) << "ft merge" << std::setw(10) << times[3] << " ms" << std::endl;
+	return (0);
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <time.h>
+#include "../../vector.hpp"
+#include "../../parallel.hpp"
+
+#define ELEMENTS (1 << 24)
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+struct square
+{
+	long operator()(int x) const
+	{
+		return static_cast<long>(x) * x;
+	}
+};
+
+struct accumulate
+{
+	void operator()(int& x) const
+	{
+		x = x * 3 + 1;
+	}
+};
+
+int main()
+{
+	srand(42);
+	ft::vector<int> input(ELEMENTS, 0);
+	for (size_t i = 0; i < input.size(); i++)
+		input[i] = rand();
+	ft::vector<int> work(input);
+	ft::vector<long> squares(ELEMENTS, 0);
+
+	unsigned maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads == 0)
+		maxThreads = 1;
+	std::cout << ELEMENTS << " ints, times in ms" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(10) << "for_each" << std::setw(10) << "transform"
+		<< std::setw(10) << "reduce" << std::setw(10) << "fill" << std::setw(10) << "copy"
+		<< std::setw(10) << "sort" << std::setw(10) << "speedup" << std::endl;
+
+	double serialTotal = 0;
+	for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		ft::parallel::threadPool pool(threads);
+		ft::parallel::options opts(&pool);
+		double times[6];
+		double start;
+
+		start = nowMs();
+		ft::parallel::for_each(work.begin(), work.end(), accumulate(), opts);
+		times[0] = nowMs() - start;
+
+		start = nowMs();
+		ft::parallel::transform(input.begin(), input.end(), squares.begin(), square(), opts);
+		times[1] = nowMs() - start;
+
+		start = nowMs();
+		long sum = ft::parallel::reduce(squares.begin(), squares.end(), 0L, std::plus<long>(), opts);
+		times[2] = nowMs() - start;
+
+		start = nowMs();
+		ft::parallel::fill(work.begin(), work.end(), 7, opts);
+		times[3] = nowMs() - start;
+
+		start = nowMs();
+		ft::parallel::copy(input.begin(), input.end(), work.begin(), opts);
+		times[4] = nowMs() - start;
+
+		start = nowMs();
+		ft::parallel::sort(work.begin(), work.end(), std::less<int>(), opts);
+		times[5] = nowMs() - start;
+
+		long expected = 0;
+		for (size_t i = 0; i < squares.size(); i++)
+			expected += squares[i];
+		if (sum != expected || !std::is_sorted(work.begin(), work.end()))
+		{
+			std::cerr << "bench_parallel: wrong result with " << threads << " threads" << std::endl;
+			return (1);
+		}
+
+		double total = 0;
+		for (int i = 0; i < 6; i++)
+			total += times[i];
+		if (threads == 1)
+			serialTotal = total;
+		std::cout << std::setw(8) << threads << std::fixed << std::setprecision(1);
+		for (int i = 0; i < 6; i++)
+			std::cout << std::setw(10) << times[i];
+		std::cout << std::setw(9) << std::setprecision(2) << serialTotal / total << "x" << std::endl;
+	}
+	return (0);
+}
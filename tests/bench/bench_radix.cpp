@@ -0,0 +1,131 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+#include "../../vector.hpp"
+#include "../../sort.hpp"
+
+// up to 1e8 with -D MAX_ELEMENTS=100000000 (about 5 GB for the pair rows)
+#ifndef MAX_ELEMENTS
+	#define MAX_ELEMENTS 10000000
+#endif
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::pair<unsigned long long, unsigned>	keyedRow;
+
+bool	rowLess(const keyedRow& lhs, const keyedRow& rhs)
+{
+	return lhs.first < rhs.first;
+}
+
+unsigned long long	random64()
+{
+	return (static_cast<unsigned long long>(rand()) << 33) ^ (static_cast<unsigned long long>(rand()) << 11) ^ rand();
+}
+
+template<typename Container, typename Compare>
+bool	sameOrder(const Container& lhs, const Container& rhs, Compare less)
+{
+	for (size_t i = 0; i < lhs.size(); i++)
+		if (less(lhs[i], rhs[i]) || less(rhs[i], lhs[i]))
+			return false;
+	return true;
+}
+
+bool	intLess(int lhs, int rhs)
+{
+	return lhs < rhs;
+}
+
+bool	unsignedLess(unsigned lhs, unsigned rhs)
+{
+	return lhs < rhs;
+}
+
+void	printRow(const char* name, size_t n, double stdTime, double radixTime)
+{
+	std::cout << std::setw(22) << name << std::setw(12) << n << std::fixed << std::setprecision(2)
+		<< std::setw(12) << stdTime << std::setw(12) << radixTime << std::setw(9) << stdTime / radixTime << "x" << std::endl;
+}
+
+int main()
+{
+	srand(42);
+	// warm-up, so the first timed sort does not pay for the cold caches
+	ft::vector<unsigned> warmUp;
+	for (size_t i = 0; i < 100000; i++)
+		warmUp.push_back(rand());
+	ft::vector<unsigned> warmUpCopy(warmUp);
+	std::sort(warmUp.begin(), warmUp.end());
+	ft::radix_sort(warmUpCopy.begin(), warmUpCopy.end());
+	std::cout << "times in ms" << std::endl;
+	std::cout << std::setw(22) << "elements" << std::setw(12) << "n" << std::setw(12) << "std::sort" << std::setw(12) << "radix_sort"
+		<< std::setw(10) << "speedup" << std::endl;
+	for (size_t n = 10000; n <= MAX_ELEMENTS; n *= 10)
+	{
+		double start;
+		double stdTime;
+		double radixTime;
+
+		ft::vector<unsigned> unsignedKeys;
+		for (size_t i = 0; i < n; i++)
+			unsignedKeys.push_back(static_cast<unsigned>(random64()));
+		ft::vector<unsigned> expectedUnsigned(unsignedKeys);
+		start = nowMs();
+		std::sort(expectedUnsigned.begin(), expectedUnsigned.end());
+		stdTime = nowMs() - start;
+		start = nowMs();
+		ft::radix_sort(unsignedKeys.begin(), unsignedKeys.end());
+		radixTime = nowMs() - start;
+		if (!sameOrder(unsignedKeys, expectedUnsigned, unsignedLess))
+		{
+			std::cerr << "bench_radix: unsigned keys out of order" << std::endl;
+			return (1);
+		}
+		printRow("unsigned", n, stdTime, radixTime);
+
+		// small values: the two high bytes are the same in every key and skipped
+		ft::vector<int> intKeys;
+		for (size_t i = 0; i < n; i++)
+			intKeys.push_back(rand() % 65536);
+		ft::vector<int> expectedInt(intKeys);
+		start = nowMs();
+		std::sort(expectedInt.begin(), expectedInt.end());
+		stdTime = nowMs() - start;
+		start = nowMs();
+		ft::radix_sort(intKeys.begin(), intKeys.end());
+		radixTime = nowMs() - start;
+		if (!sameOrder(intKeys, expectedInt, intLess))
+		{
+			std::cerr << "bench_radix: int keys out of order" << std::endl;
+			return (1);
+		}
+		printRow("int (0..65535)", n, stdTime, radixTime);
+
+		ft::vector<keyedRow> rows;
+		for (size_t i = 0; i < n; i++)
+			rows.push_back(keyedRow(random64(), static_cast<unsigned>(i)));
+		ft::vector<keyedRow> expectedRows(rows);
+		start = nowMs();
+		std::sort(expectedRows.begin(), expectedRows.end(), rowLess);
+		stdTime = nowMs() - start;
+		start = nowMs();
+		ft::radix_sort(rows.begin(), rows.end());
+		radixTime = nowMs() - start;
+		if (!sameOrder(rows, expectedRows, rowLess))
+		{
+			std::cerr << "bench_radix: pair rows out of order" << std::endl;
+			return (1);
+		}
+		printRow("pair<uint64, unsigned>", n, stdTime, radixTime);
+	}
+	return (0);
+}
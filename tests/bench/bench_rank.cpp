@@ -0,0 +1,101 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../map.hpp"
+
+#define ELEMENTS (1 << 18)
+#define QUERIES 99
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+typedef ft::map<int, int>	intMap;
+
+// the p-th percentile key by walking the iterators, as without subtree sizes
+int	linearPercentile(const intMap& m, int p)
+{
+	size_t idx = m.size() * p / 100;
+	intMap::const_iterator it = m.begin();
+	for (size_t i = 0; i < idx; i++)
+		++it;
+	return it->first;
+}
+
+size_t	linearRank(const intMap& m, int key)
+{
+	size_t n = 0;
+	for (intMap::const_iterator it = m.begin(); it != m.end() && it->first < key; ++it)
+		++n;
+	return n;
+}
+
+int main()
+{
+	srand(42);
+	intMap m;
+	while (m.size() < ELEMENTS)
+		m.insert(ft::make_pair(rand(), 0));
+
+	double start;
+	long linearSum = 0;
+	long fastSum = 0;
+
+	std::cout << ELEMENTS << " random keys, " << QUERIES << " queries each, times in ms" << std::endl;
+	std::cout << std::setw(12) << "query" << std::setw(12) << "linear" << std::setw(12) << "indexed" << std::setw(10) << "speedup" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+
+	double times[3][2];
+
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+		linearSum += linearPercentile(m, p);
+	times[0][0] = nowMs() - start;
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+		fastSum += m.select(m.size() * p / 100)->first;
+	times[0][1] = nowMs() - start;
+
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+		linearSum += linearRank(m, RAND_MAX / 100 * p);
+	times[1][0] = nowMs() - start;
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+		fastSum += m.rank(RAND_MAX / 100 * p);
+	times[1][1] = nowMs() - start;
+
+	// distance between the percentile iterators, found once up front
+	intMap::iterator marks[QUERIES + 1];
+	for (int p = 0; p <= QUERIES; p++)
+		marks[p] = m.select(m.size() * p / 100);
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+	{
+		long n = 0;
+		for (intMap::iterator it = marks[0]; it != marks[p]; ++it)
+			++n;
+		linearSum += n;
+	}
+	times[2][0] = nowMs() - start;
+	start = nowMs();
+	for (int p = 1; p <= QUERIES; p++)
+		fastSum += ft::distance(marks[0], marks[p]);
+	times[2][1] = nowMs() - start;
+
+	if (linearSum != fastSum)
+	{
+		std::cerr << "bench_rank: indexed queries disagree with the linear walk" << std::endl;
+		return (1);
+	}
+	const char* names[3] = { "select", "rank", "distance" };
+	for (int i = 0; i < 3; i++)
+		std::cout << std::setw(12) << names[i] << std::setw(12) << times[i][0] << std::setw(12) << times[i][1]
+			<< std::setw(9) << std::setprecision(0) << times[i][0] / times[i][1] << "x" << std::setprecision(3) << std::endl;
+	return (0);
+}
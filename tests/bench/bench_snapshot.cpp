@@ -0,0 +1,157 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <unistd.h>
+#include "../../map.hpp"
+#include "../../vector.hpp"
+#include "../../snapshot.hpp"
+
+#ifndef VECTOR_ELEMENTS
+	#define VECTOR_ELEMENTS 10000000
+#endif
+
+#ifndef MAP_ELEMENTS
+	#define MAP_ELEMENTS 1000000
+#endif
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+int	randomInt()
+{
+	return ((rand() << 15) ^ rand());
+}
+
+typedef ft::vector<int>		intVector;
+typedef ft::map<int, int>	intMap;
+
+void	printRow(const char* name, size_t n, size_t bytes, double textTime, double streamTime, double fdTime)
+{
+	std::cout << std::setw(8) << name << std::setw(10) << n << std::setw(12) << bytes << std::fixed << std::setprecision(2)
+		<< std::setw(10) << textTime << std::setw(10) << streamTime << std::setw(10) << fdTime
+		<< std::setw(9) << textTime / fdTime << "x" << std::endl;
+}
+
+// a file that is deleted when it is closed
+int	scratchFile(FILE*& file)
+{
+	file = tmpfile();
+	if (!file)
+	{
+		std::cerr << "bench_snapshot: tmpfile failed" << std::endl;
+		exit(1);
+	}
+	return fileno(file);
+}
+
+int	benchVector()
+{
+	intVector vec;
+	for (size_t i = 0; i < VECTOR_ELEMENTS; i++)
+		vec.push_back(randomInt());
+
+	std::stringstream text;
+	for (size_t i = 0; i < vec.size(); i++)
+		text << vec[i] << '\n';
+	double start = nowMs();
+	intVector fromText;
+	int value;
+	while (text >> value)
+		fromText.push_back(value);
+	double textTime = nowMs() - start;
+
+	std::stringstream bytes;
+	ft::save(bytes, vec);
+	start = nowMs();
+	intVector fromStream;
+	ft::load(bytes, fromStream);
+	double streamTime = nowMs() - start;
+
+	FILE* file;
+	int fd = scratchFile(file);
+	ft::save(fd, vec);
+	lseek(fd, 0, SEEK_SET);
+	start = nowMs();
+	intVector fromFd;
+	ft::load(fd, fromFd);
+	double fdTime = nowMs() - start;
+	fclose(file);
+
+	if (fromText != vec || fromStream != vec || fromFd != vec)
+	{
+		std::cerr << "bench_snapshot: vector loads differ" << std::endl;
+		return (1);
+	}
+	printRow("vector", vec.size(), bytes.str().size(), textTime, streamTime, fdTime);
+	return (0);
+}
+
+int	benchMap()
+{
+	// the text rows stay in insertion order: inserting sorted rows one by
+	// one degenerates the unbalanced tree into a list
+	intVector keys;
+	intMap mp;
+	while (mp.size() < MAP_ELEMENTS)
+	{
+		int k = randomInt();
+		if (mp.insert(ft::make_pair(k, k / 3)).second)
+			keys.push_back(k);
+	}
+
+	std::stringstream text;
+	for (size_t i = 0; i < keys.size(); i++)
+		text << keys[i] << ' ' << mp[keys[i]] << '\n';
+	double start = nowMs();
+	intMap fromText;
+	int key;
+	int value;
+	while (text >> key >> value)
+		fromText.insert(ft::make_pair(key, value));
+	double textTime = nowMs() - start;
+
+	std::stringstream bytes;
+	ft::save(bytes, mp);
+	start = nowMs();
+	intMap fromStream;
+	ft::load(bytes, fromStream);
+	double streamTime = nowMs() - start;
+
+	FILE* file;
+	int fd = scratchFile(file);
+	ft::save(fd, mp);
+	lseek(fd, 0, SEEK_SET);
+	start = nowMs();
+	intMap fromFd;
+	ft::load(fd, fromFd);
+	double fdTime = nowMs() - start;
+	fclose(file);
+
+	if (fromText != mp || fromStream != mp || fromFd != mp)
+	{
+		std::cerr << "bench_snapshot: map loads differ" << std::endl;
+		return (1);
+	}
+	printRow("map", mp.size(), bytes.str().size(), textTime, streamTime, fdTime);
+	return (0);
+}
+
+int main()
+{
+	srand(42);
+	std::cout << "load times in ms: text parsed element by element, binary snapshot from a stream and from a file" << std::endl;
+	std::cout << std::setw(8) << "load" << std::setw(10) << "n" << std::setw(12) << "bytes" << std::setw(10) << "text"
+		<< std::setw(10) << "stream" << std::setw(10) << "fd" << std::setw(10) << "speedup" << std::endl;
+	if (benchVector() || benchMap())
+		return (1);
+	return (0);
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <time.h>
+#include "../../vector.hpp"
+#include "../../soa_vector.hpp"
+#include "../../parallel.hpp"
+
+#define ELEMENTS (1 << 21)
+#define REPEAT 20
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+struct Payload
+{
+	double weight[7];
+};
+
+// 64 bytes per record, the hot loop only reads value
+struct Record
+{
+	int		value;
+	int		id;
+	Payload	payload;
+};
+
+int main()
+{
+	srand(42);
+	ft::vector<Record> aos;
+	ft::soa_vector<int, int, Payload> soa;
+	aos.reserve(ELEMENTS);
+	soa.reserve(ELEMENTS);
+	for (int i = 0; i < ELEMENTS; i++)
+	{
+		Record r;
+		r.value = rand() % 1000;
+		r.id = i;
+		for (int j = 0; j < 7; j++)
+			r.payload.weight[j] = j;
+		aos.push_back(r);
+		soa.push_back(r.value, r.id, r.payload);
+	}
+
+	long aosSum = 0;
+	double start = nowMs();
+	for (int r = 0; r < REPEAT; r++)
+		for (size_t i = 0; i < aos.size(); i++)
+			aosSum += aos[i].value;
+	double aosTime = (nowMs() - start) / REPEAT;
+
+	long soaSum = 0;
+	ft::span<int> values = soa.column<0>();
+	start = nowMs();
+	for (int r = 0; r < REPEAT; r++)
+		for (size_t i = 0; i < values.size(); i++)
+			soaSum += values[i];
+	double soaTime = (nowMs() - start) / REPEAT;
+
+	long parallelSum = 0;
+	start = nowMs();
+	for (int r = 0; r < REPEAT; r++)
+		parallelSum += ft::parallel::reduce(values.begin(), values.end(), 0L, std::plus<long>());
+	double parallelTime = (nowMs() - start) / REPEAT;
+
+	if (aosSum != soaSum || soaSum != parallelSum)
+	{
+		std::cerr << "bench_soa: sums differ" << std::endl;
+		return (1);
+	}
+	std::cout << ELEMENTS << " records of " << sizeof(Record) << " bytes, single int field sum" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "ft::vector<Record>      " << std::setw(8) << aosTime << " ms" << std::endl;
+	std::cout << "ft::soa_vector column   " << std::setw(8) << soaTime << " ms  (" << aosTime / soaTime << "x)" << std::endl;
+	std::cout << "ft::parallel::reduce    " << std::setw(8) << parallelTime << " ms  (" << aosTime / parallelTime << "x)" << std::endl;
+	return (0);
+}
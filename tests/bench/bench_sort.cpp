@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+#include "../../vector.hpp"
+#include "../../sort.hpp"
+
+#define ELEMENTS 1000000
+#define DISTRIBUTIONS 5
+
+double	nowMs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e3 + ts.tv_nsec / 1e6);
+}
+
+const char*	distributionNames[DISTRIBUTIONS] = { "random", "sorted", "reversed", "16 distinct", "sorted + 1%" };
+
+ft::vector<int>	makeInput(int distribution)
+{
+	ft::vector<int> input;
+	for (int i = 0; i < ELEMENTS; i++)
+	{
+		if (distribution == 0)
+			input.push_back(rand());
+		else if (distribution == 1)
+			input.push_back(i);
+		else if (distribution == 2)
+			input.push_back(ELEMENTS - i);
+		else if (distribution == 3)
+			input.push_back(rand() % 16);
+		else
+			input.push_back(i % 100 ? i : rand());
+	}
+	return input;
+}
+
+// key and position: stable_sort must keep the positions of equal keys ascending
+struct record
+{
+	int	key;
+	int	position;
+};
+
+bool	recordLess(const record& lhs, const record& rhs)
+{
+	return lhs.key < rhs.key;
+}
+
+bool	sameRecords(const ft::vector<record>& lhs, const ft::vector<record>& rhs)
+{
+	for (size_t i = 0; i < lhs.size(); i++)
+		if (lhs[i].key != rhs[i].key || lhs[i].position != rhs[i].position)
+			return false;
+	return true;
+}
+
+void	printRow(const char* name, double stdTime, double ftTime)
+{
+	std::cout << std::setw(14) << name << std::fixed << std::setprecision(2) << std::setw(12) << stdTime
+		<< std::setw(12) << ftTime << std::setw(9) << stdTime / ftTime << "x";
+}
+
+int main()
+{
+	srand(42);
+	double start;
+	std::cout << ELEMENTS << " ints, times in ms" << std::endl;
+	std::cout << std::setw(14) << "input" << std::setw(12) << "std::sort" << std::setw(12) << "ft::sort" << std::setw(10) << "speedup"
+		<< std::setw(14) << "std::stable" << std::setw(12) << "ft::stable" << std::setw(10) << "speedup" << std::endl;
+	for (int d = 0; d < DISTRIBUTIONS; d++)
+	{
+		ft::vector<int> input = makeInput(d);
+		ft::vector<int> expected(input);
+		ft::vector<int> sorted(input);
+		start = nowMs();
+		std::sort(expected.begin(), expected.end());
+		double stdTime = nowMs() - start;
+		start = nowMs();
+		ft::sort(sorted.begin(), sorted.end());
+		double ftTime = nowMs() - start;
+		if (sorted != expected)
+		{
+			std::cerr << "bench_sort: ft::sort disagrees with std::sort on " << distributionNames[d] << " input" << std::endl;
+			return (1);
+		}
+		printRow(distributionNames[d], stdTime, ftTime);
+
+		ft::vector<record> records;
+		for (int i = 0; i < ELEMENTS; i++)
+		{
+			record r = { input[i], i };
+			records.push_back(r);
+		}
+		ft::vector<record> expectedRecords(records);
+		start = nowMs();
+		std::stable_sort(expectedRecords.begin(), expectedRecords.end(), recordLess);
+		stdTime = nowMs() - start;
+		start = nowMs();
+		ft::stable_sort(records.begin(), records.end(), recordLess);
+		ftTime = nowMs() - start;
+		if (!sameRecords(records, expectedRecords))
+		{
+			std::cerr << "bench_sort: ft::stable_sort disagrees with std::stable_sort on " << distributionNames[d] << " input" << std::endl;
+			return (1);
+		}
+		std::cout << std::setw(14) << stdTime << std::setw(12) << ftTime << std::setw(9) << stdTime / ftTime << "x" << std::endl;
+	}
+	return (0);
+}
@@ -0,0 +1,1090 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <cerrno>
+#include <time.h>
+#ifdef __linux__
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+#include <vector>
+#include <map>
+#include <stack>
+#include <deque>
+#include "../../vector.hpp"
+#include "../../map.hpp"
+#include "../../stack.hpp"
+#include "../../tracking_allocator.hpp"
+#include "../../latency.hpp"
+
+// Side-by-side ft vs std timings for the core container operations.
+//
+// Every case runs once untimed as a warm-up, then REPEATS times. The timed
+// loops are cut into chunks of CHUNK_OPS operations and each chunk gives
+// one ns/op sample: the median and p99 are taken over all the samples of
+// all the repeats. Setup (building the map a lookup runs against, say) is
+// never timed.
+//
+//   ft_bench [--max=N] [--csv=PATH] [--json=PATH] [--perf]
+//
+// prints a table and writes the same rows to bench_suite.csv and
+// bench_suite.json unless other paths are given. With --perf, on Linux,
+// the timed loops also read the hardware counters (perf_event_open) and
+// every row gets their values per operation; counters the kernel or the
+// CPU does not provide are left out, and the timings are unaffected.
+//
+// A second table gives the bytes per element each container holds, counted
+// by ft::tracking_allocator, and what an empty map costs. A third times push_back, insert, erase and find
+// one call at a time into latency histograms (latency.hpp), for the tails that
+// chunked medians average away: the p99.9 and max of push_back are the
+// reallocations.
+
+#ifndef MAX_ELEMENTS
+	#define MAX_ELEMENTS 10000000
+#endif
+
+// a tree of 1e7 nodes takes long enough to build that every map case at
+// that size runs for minutes: raise this to MAX_ELEMENTS when needed
+#ifndef MAP_MAX_ELEMENTS
+	#define MAP_MAX_ELEMENTS 1000000
+#endif
+
+// ft::map does not rebalance, sorted keys make it a list: O(n^2) to build
+// and to iterate, as every step of the iterator looks up the root again
+#ifndef SORTED_MAP_MAX_ELEMENTS
+	#define SORTED_MAP_MAX_ELEMENTS 1000
+#endif
+
+#ifndef REPEATS
+	#define REPEATS 5
+#endif
+
+#define CHUNK_OPS 1000
+
+double	nowNs()
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+// keeps the compiler from dropping loops whose results are not used
+inline void	clobber()
+{
+	__asm__ __volatile__("" : : : "memory");
+}
+
+/******************** WORKLOADS ********************/
+
+// xorshift64*, so the workloads are the same on every platform
+struct random64
+{
+	unsigned long long	state;
+
+	explicit random64(unsigned long long seed)
+		: state(seed) { }
+
+	unsigned long long next()
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 2685821657736338717ULL;
+	}
+
+	// uniform in [0, 1)
+	double unit()
+	{
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+};
+
+enum distribution
+{
+	NONE,
+	SORTED,
+	RANDOM,
+	ZIPF
+};
+
+const char*	distributionName(distribution dist)
+{
+	static const char*	names[] = { "-", "sorted", "random", "zipf" };
+
+	return names[dist];
+}
+
+// keys: the values in insertion order; probes: the lookup order, every
+// probe in [0, n) so that it also serves as a vector index
+struct workload
+{
+	size_t				n;
+	ft::vector<int>		keys;
+	ft::vector<int>		probes;
+};
+
+// Zipf with s = 1 over n ranks, drawn by inverting the cumulative
+// distribution; the ranks are scattered over the key space so that the
+// hot keys are not also the smallest ones
+void	zipfDraws(size_t n, size_t count, const ft::vector<int>& scatter, random64& rng, ft::vector<int>& out)
+{
+	ft::vector<double> cumulative(n);
+	double total = 0;
+	for (size_t rank = 0; rank < n; rank++)
+	{
+		total += 1.0 / (rank + 1);
+		cumulative[rank] = total;
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		double target = rng.unit() * total;
+		size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+		out.push_back(scatter[std::min(rank, n - 1)]);
+	}
+}
+
+void	buildWorkload(workload& w, size_t n, distribution dist)
+{
+	random64 rng(0x9E3779B97F4A7C15ULL ^ n ^ (static_cast<unsigned long long>(dist) << 56));
+
+	w.n = n;
+	w.keys.clear();
+	w.probes.clear();
+	ft::vector<int> shuffled(n);
+	for (size_t i = 0; i < n; i++)
+		shuffled[i] = static_cast<int>(i);
+	for (size_t i = n; i > 1; i--)
+		std::swap(shuffled[i - 1], shuffled[rng.next() % i]);
+	if (dist == ZIPF)
+	{
+		zipfDraws(n, n, shuffled, rng, w.keys);
+		zipfDraws(n, n, shuffled, rng, w.probes);
+		return;
+	}
+	if (dist == RANDOM)
+	{
+		w.keys = shuffled;
+		for (size_t i = 0; i < n; i++)
+			w.probes.push_back(static_cast<int>(rng.next() % n));
+		return;
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		w.keys.push_back(static_cast<int>(i));
+		w.probes.push_back(static_cast<int>(i));
+	}
+}
+
+/******************** HARDWARE COUNTERS ********************/
+
+// Each counter is opened on its own rather than as a group, so that a CPU
+// or a VM without, say, a dTLB event still gives the others. Values are
+// scaled by enabled / running time in case the kernel multiplexed them.
+class hardwareCounters
+{
+public:
+	enum event
+	{
+		CYCLES,
+		INSTRUCTIONS,
+		L1D_MISSES,
+		LLC_MISSES,
+		BRANCH_MISSES,
+		DTLB_MISSES,
+		EVENT_COUNT
+	};
+
+	hardwareCounters()
+	{
+		for (int e = 0; e < EVENT_COUNT; e++)
+		{
+			fds[e] = -1;
+			totals[e] = 0;
+		}
+	}
+
+	~hardwareCounters()
+	{
+#ifdef __linux__
+		for (int e = 0; e < EVENT_COUNT; e++)
+			if (fds[e] != -1)
+				close(fds[e]);
+#endif
+	}
+
+	static const char* name(int e)
+	{
+		static const char*	names[] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses" };
+
+		return names[e];
+	}
+
+	// opens what it can; false, with the reason, when nothing opened
+	bool open(std::string& reason)
+	{
+#ifdef __linux__
+		const unsigned long long cacheReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		const unsigned types[EVENT_COUNT] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE };
+		const unsigned long long configs[EVENT_COUNT] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_L1D | cacheReadMiss, PERF_COUNT_HW_CACHE_LL | cacheReadMiss,
+			PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_DTLB | cacheReadMiss };
+		int opened = 0;
+		int error = 0;
+		for (int e = 0; e < EVENT_COUNT; e++)
+		{
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = types[e];
+			attr.config = configs[e];
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fds[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+			if (fds[e] == -1)
+				error = errno;
+			else
+				++opened;
+		}
+		if (opened == 0)
+			reason = std::strerror(error);
+		return opened != 0;
+#else
+		reason = "perf_event_open is Linux only";
+		return false;
+#endif
+	}
+
+	bool available(int e) const
+	{
+		return fds[e] != -1;
+	}
+
+	void start()
+	{
+#ifdef __linux__
+		for (int e = 0; e < EVENT_COUNT; e++)
+		{
+			if (fds[e] == -1)
+				continue;
+			ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+			ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	void stop()
+	{
+#ifdef __linux__
+		for (int e = 0; e < EVENT_COUNT; e++)
+			if (fds[e] != -1)
+				ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+		for (int e = 0; e < EVENT_COUNT; e++)
+		{
+			unsigned long long reading[3];
+			if (fds[e] == -1 || read(fds[e], reading, sizeof(reading)) != sizeof(reading) || reading[2] == 0)
+				continue;
+			totals[e] += static_cast<double>(reading[0]) * reading[1] / reading[2];
+		}
+#endif
+	}
+
+	void clear()
+	{
+		for (int e = 0; e < EVENT_COUNT; e++)
+			totals[e] = 0;
+	}
+
+	double total(int e) const
+	{
+		return totals[e];
+	}
+
+private:
+	int		fds[EVENT_COUNT];
+	double	totals[EVENT_COUNT];
+};
+
+/******************** TIMING ********************/
+
+// collects one ns/op sample per CHUNK_OPS operations, and the hardware
+// counters over the timed loops when it is given some
+class stopwatch
+{
+public:
+	explicit stopwatch(hardwareCounters* counters = NULL)
+		: counters(counters), last(0), pending(0), operations(0) { }
+
+	void start()
+	{
+		pending = 0;
+		if (counters)
+			counters->start();
+		last = nowNs();
+	}
+
+	// counts one operation, closing the chunk when it is full
+	void tick()
+	{
+		if (++pending == CHUNK_OPS)
+			lap();
+	}
+
+	// counts the operations of a step that cannot be cut into chunks
+	void count(size_t ops)
+	{
+		pending += ops;
+	}
+
+	// closes the current chunk, whatever its size
+	void stop()
+	{
+		if (pending != 0)
+			lap();
+		if (counters)
+			counters->stop();
+	}
+
+	void clear()
+	{
+		samples.clear();
+		operations = 0;
+		if (counters)
+			counters->clear();
+	}
+
+	size_t counted() const
+	{
+		return operations;
+	}
+
+	const ft::vector<double>& results() const
+	{
+		return samples;
+	}
+
+private:
+	void lap()
+	{
+		double now = nowNs();
+		samples.push_back((now - last) / pending);
+		operations += pending;
+		pending = 0;
+		last = now;
+	}
+
+	hardwareCounters*	counters;
+	ft::vector<double>	samples;
+	double				last;
+	size_t				pending;
+	size_t				operations;
+};
+
+// perOp[e] is meaningful only where counted[e]
+struct summary
+{
+	double	median;
+	double	p99;
+	bool	counted[hardwareCounters::EVENT_COUNT];
+	double	perOp[hardwareCounters::EVENT_COUNT];
+};
+
+summary	summarize(const ft::vector<double>& samples)
+{
+	std::vector<double> sorted(samples.begin(), samples.end());
+	std::sort(sorted.begin(), sorted.end());
+	summary result;
+	for (int e = 0; e < hardwareCounters::EVENT_COUNT; e++)
+	{
+		result.counted[e] = false;
+		result.perOp[e] = 0;
+	}
+	result.median = sorted[sorted.size() / 2];
+	result.p99 = sorted[static_cast<size_t>(std::ceil(0.99 * sorted.size())) - 1];
+	return result;
+}
+
+/******************** CASES ********************/
+
+template<typename Vector>
+void	vectorPushBack(const workload& w, stopwatch& watch)
+{
+	Vector vec;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		vec.push_back(w.keys[i]);
+		watch.tick();
+	}
+	watch.stop();
+	clobber();
+}
+
+template<typename Vector>
+void	vectorIndex(const workload& w, stopwatch& watch)
+{
+	Vector vec(w.keys.begin(), w.keys.end());
+	long long sum = 0;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		sum += vec[w.probes[i]];
+		watch.tick();
+	}
+	watch.stop();
+	if (sum == -1)
+		std::cerr << sum;
+}
+
+template<typename Vector>
+void	vectorIterate(const workload& w, stopwatch& watch)
+{
+	Vector vec(w.keys.begin(), w.keys.end());
+	long long sum = 0;
+	watch.start();
+	for (typename Vector::iterator it = vec.begin(); it != vec.end(); ++it)
+	{
+		sum += *it;
+		watch.tick();
+	}
+	watch.stop();
+	if (sum == -1)
+		std::cerr << sum;
+}
+
+template<typename Vector>
+void	vectorPopBack(const workload& w, stopwatch& watch)
+{
+	Vector vec(w.keys.begin(), w.keys.end());
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		vec.pop_back();
+		watch.tick();
+	}
+	watch.stop();
+	clobber();
+}
+
+// one sample per copy, in ns per element
+template<typename Vector>
+void	vectorCopy(const workload& w, stopwatch& watch)
+{
+	Vector vec(w.keys.begin(), w.keys.end());
+	size_t copies = std::max<size_t>(1, CHUNK_OPS * 100 / w.n);
+	for (size_t i = 0; i < copies; i++)
+	{
+		watch.start();
+		{
+			Vector copy(vec);
+			clobber();
+		}
+		watch.count(w.n);
+		watch.stop();
+	}
+}
+
+template<typename Map>
+void	buildMap(Map& mp, const workload& w)
+{
+	for (size_t i = 0; i < w.n; i++)
+		mp.insert(typename Map::value_type(w.keys[i], static_cast<int>(i)));
+}
+
+template<typename Map>
+void	mapInsert(const workload& w, stopwatch& watch)
+{
+	Map mp;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		mp.insert(typename Map::value_type(w.keys[i], static_cast<int>(i)));
+		watch.tick();
+	}
+	watch.stop();
+	clobber();
+}
+
+template<typename Map>
+void	mapFind(const workload& w, stopwatch& watch)
+{
+	Map mp;
+	buildMap(mp, w);
+	size_t hits = 0;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		hits += mp.find(w.probes[i]) != mp.end();
+		watch.tick();
+	}
+	watch.stop();
+	if (hits > w.n)
+		std::cerr << hits;
+}
+
+template<typename Map>
+void	mapIterate(const workload& w, stopwatch& watch)
+{
+	Map mp;
+	buildMap(mp, w);
+	long long sum = 0;
+	watch.start();
+	for (typename Map::iterator it = mp.begin(); it != mp.end(); ++it)
+	{
+		sum += it->second;
+		watch.tick();
+	}
+	watch.stop();
+	if (sum == -1)
+		std::cerr << sum;
+}
+
+template<typename Map>
+void	mapErase(const workload& w, stopwatch& watch)
+{
+	Map mp;
+	buildMap(mp, w);
+	size_t erased = 0;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		erased += mp.erase(w.keys[i]);
+		watch.tick();
+	}
+	watch.stop();
+	if (erased > w.n)
+		std::cerr << erased;
+}
+
+template<typename Stack>
+void	stackPush(const workload& w, stopwatch& watch)
+{
+	Stack st;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		st.push(w.keys[i]);
+		watch.tick();
+	}
+	watch.stop();
+	clobber();
+}
+
+template<typename Stack>
+void	stackTopPop(const workload& w, stopwatch& watch)
+{
+	Stack st;
+	for (size_t i = 0; i < w.n; i++)
+		st.push(w.keys[i]);
+	long long sum = 0;
+	watch.start();
+	for (size_t i = 0; i < w.n; i++)
+	{
+		sum += st.top();
+		st.pop();
+		watch.tick();
+	}
+	watch.stop();
+	if (sum == -1)
+		std::cerr << sum;
+}
+
+typedef void	(*benchFunction)(const workload&, stopwatch&);
+
+struct benchCase
+{
+	const char*		container;
+	const char*		operation;
+	bool			keyed;
+	size_t			maxElements;
+	size_t			maxSortedElements;
+	benchFunction	ft;
+	benchFunction	std;
+};
+
+typedef ft::vector<int>			ftVector;
+typedef std::vector<int>		stdVector;
+typedef ft::map<int, int>		ftMap;
+typedef std::map<int, int>		stdMap;
+typedef ft::stack<int>			ftStack;
+typedef std::stack<int>			stdStack;
+
+const benchCase	cases[] = {
+	{ "vector", "push_back", false, MAX_ELEMENTS, MAX_ELEMENTS, vectorPushBack<ftVector>, vectorPushBack<stdVector> },
+	{ "vector", "operator[]", true, MAX_ELEMENTS, MAX_ELEMENTS, vectorIndex<ftVector>, vectorIndex<stdVector> },
+	{ "vector", "iterate", false, MAX_ELEMENTS, MAX_ELEMENTS, vectorIterate<ftVector>, vectorIterate<stdVector> },
+	{ "vector", "pop_back", false, MAX_ELEMENTS, MAX_ELEMENTS, vectorPopBack<ftVector>, vectorPopBack<stdVector> },
+	{ "vector", "copy", false, MAX_ELEMENTS, MAX_ELEMENTS, vectorCopy<ftVector>, vectorCopy<stdVector> },
+	{ "map", "insert", true, MAP_MAX_ELEMENTS, SORTED_MAP_MAX_ELEMENTS, mapInsert<ftMap>, mapInsert<stdMap> },
+	{ "map", "find", true, MAP_MAX_ELEMENTS, SORTED_MAP_MAX_ELEMENTS, mapFind<ftMap>, mapFind<stdMap> },
+	{ "map", "iterate", true, MAP_MAX_ELEMENTS, SORTED_MAP_MAX_ELEMENTS, mapIterate<ftMap>, mapIterate<stdMap> },
+	{ "map", "erase", true, MAP_MAX_ELEMENTS, SORTED_MAP_MAX_ELEMENTS, mapErase<ftMap>, mapErase<stdMap> },
+	{ "stack", "push", false, MAX_ELEMENTS, MAX_ELEMENTS, stackPush<ftStack>, stackPush<stdStack> },
+	{ "stack", "top+pop", false, MAX_ELEMENTS, MAX_ELEMENTS, stackTopPop<ftStack>, stackTopPop<stdStack> }
+};
+
+/******************** MEMORY ********************/
+
+struct memoryTag { };
+
+typedef ft::tracking_allocator<int, memoryTag>						intTracking;
+typedef ft::vector<int, intTracking>								ftTrackedVector;
+typedef std::vector<int, intTracking>								stdTrackedVector;
+typedef ft::map<int, int, std::less<int>,
+	ft::tracking_allocator<ft::pair<const int, int>, memoryTag> >	ftTrackedMap;
+typedef std::map<int, int, std::less<int>,
+	ft::tracking_allocator<std::pair<const int, int>, memoryTag> >	stdTrackedMap;
+typedef ft::stack<int, ftTrackedVector>							ftTrackedStack;
+typedef std::stack<int, std::deque<int, intTracking> >				stdTrackedStack;
+
+// a mapped value much larger than a node's links
+struct pageValue
+{
+	char	bytes[4096];
+};
+
+typedef ft::map<int, pageValue, std::less<int>,
+	ft::tracking_allocator<ft::pair<const int, pageValue>, memoryTag> >		ftTrackedPageMap;
+typedef std::map<int, pageValue, std::less<int>,
+	ft::tracking_allocator<std::pair<const int, pageValue>, memoryTag> >	stdTrackedPageMap;
+
+// what a container holds once filled, and the most it held on the way
+struct memoryUse
+{
+	double	liveBytes;
+	double	peakBytes;
+	size_t	allocations;
+};
+
+template<typename Vector>
+void	fillVector(Vector& vec, const workload& w)
+{
+	for (size_t i = 0; i < w.n; i++)
+		vec.push_back(w.keys[i]);
+}
+
+template<typename Map>
+void	fillMap(Map& mp, const workload& w)
+{
+	buildMap(mp, w);
+}
+
+template<typename Stack>
+void	fillStack(Stack& st, const workload& w)
+{
+	for (size_t i = 0; i < w.n; i++)
+		st.push(w.keys[i]);
+}
+
+// in bytes per element; the allocations are the blocks live at the end
+template<typename Container>
+memoryUse	measureMemory(const workload& w, void (*fill)(Container&, const workload&))
+{
+	typedef ft::allocation_tracker<memoryTag>	tracker;
+
+	memoryUse use;
+	tracker::reset_peak();
+	ft::tracking_stats before = tracker::stats();
+	{
+		Container container;
+		fill(container, w);
+		ft::tracking_stats after = tracker::stats();
+		use.liveBytes = static_cast<double>(after.live_bytes - before.live_bytes) / w.n;
+		use.allocations = after.live_allocations() - before.live_allocations();
+	}
+	use.peakBytes = static_cast<double>(tracker::stats().peak_bytes - before.live_bytes) / w.n;
+	return use;
+}
+
+// what constructing a map allocates before anything is inserted
+template<typename Map>
+memoryUse	emptyMapMemory()
+{
+	typedef ft::allocation_tracker<memoryTag>	tracker;
+
+	memoryUse use;
+	ft::tracking_stats before = tracker::stats();
+	Map mp;
+	ft::tracking_stats after = tracker::stats();
+	use.liveBytes = static_cast<double>(after.live_bytes - before.live_bytes);
+	use.peakBytes = use.liveBytes;
+	use.allocations = after.allocations - before.allocations;
+	return use;
+}
+
+template<typename FtMap, typename StdMap>
+void	printEmptyMap(const char* name)
+{
+	memoryUse ftUse = emptyMapMemory<FtMap>();
+	memoryUse stdUse = emptyMapMemory<StdMap>();
+	std::cout << std::setw(20) << name << std::setw(11) << sizeof(FtMap) << std::setw(11) << ftUse.allocations
+		<< std::setw(11) << ftUse.liveBytes << std::setw(11) << sizeof(StdMap) << std::setw(11) << stdUse.allocations
+		<< std::setw(11) << stdUse.liveBytes << std::endl;
+}
+
+void	reportEmptyMaps()
+{
+	std::cout << std::endl << "empty maps: sizeof, and the blocks and bytes the constructor allocates" << std::endl;
+	std::cout << std::setw(20) << "type" << std::setw(11) << "ft size" << std::setw(11) << "ft blocks" << std::setw(11) << "ft bytes"
+		<< std::setw(11) << "std size" << std::setw(11) << "std blocks" << std::setw(11) << "std bytes" << std::endl;
+	std::cout << std::setprecision(0);
+	printEmptyMap<ftTrackedMap, stdTrackedMap>("map<int, int>");
+	printEmptyMap<ftTrackedPageMap, stdTrackedPageMap>("map<int, 4 KiB>");
+}
+
+void	printMemoryHeader()
+{
+	std::cout << std::endl << "bytes per element (live after filling, and peak while filling)" << std::endl;
+	std::cout << std::setw(8) << "type" << std::setw(10) << "n"
+		<< std::setw(11) << "ft live" << std::setw(11) << "ft peak" << std::setw(11) << "ft blocks"
+		<< std::setw(11) << "std live" << std::setw(11) << "std peak" << std::setw(11) << "std blocks" << std::endl;
+}
+
+void	printMemoryRow(const char* container, size_t n, const memoryUse& ftUse, const memoryUse& stdUse)
+{
+	std::cout << std::setw(8) << container << std::setw(10) << n << std::fixed << std::setprecision(2)
+		<< std::setw(11) << ftUse.liveBytes << std::setw(11) << ftUse.peakBytes << std::setw(11) << ftUse.allocations
+		<< std::setw(11) << stdUse.liveBytes << std::setw(11) << stdUse.peakBytes << std::setw(11) << stdUse.allocations << std::endl;
+}
+
+void	reportMemory(size_t maxElements)
+{
+	workload w;
+
+	printMemoryHeader();
+	for (size_t n = 1000; n <= maxElements; n *= 10)
+	{
+		buildWorkload(w, n, RANDOM);
+		printMemoryRow("vector", n, measureMemory(w, fillVector<ftTrackedVector>),
+			measureMemory(w, fillVector<stdTrackedVector>));
+		if (n <= MAP_MAX_ELEMENTS)
+			printMemoryRow("map", n, measureMemory(w, fillMap<ftTrackedMap>), measureMemory(w, fillMap<stdTrackedMap>));
+		printMemoryRow("stack", n, measureMemory(w, fillStack<ftTrackedStack>), measureMemory(w, fillStack<stdTrackedStack>));
+	}
+}
+
+/******************** LATENCY ********************/
+
+template<typename Vector>
+void	pushBackLatency(const workload& w, ft::latencyHistogram& histogram)
+{
+	Vector vec;
+	for (size_t i = 0; i < w.n; i++)
+		ft::timed(histogram, [&] { vec.push_back(w.keys[i]); });
+	clobber();
+}
+
+template<typename Map>
+void	insertLatency(const workload& w, ft::latencyHistogram& histogram)
+{
+	Map mp;
+	for (size_t i = 0; i < w.n; i++)
+		ft::timed(histogram, [&] { mp.insert(typename Map::value_type(w.keys[i], static_cast<int>(i))); });
+	clobber();
+}
+
+template<typename Map>
+void	eraseLatency(const workload& w, ft::latencyHistogram& histogram)
+{
+	Map mp;
+	buildMap(mp, w);
+	for (size_t i = 0; i < w.n; i++)
+		ft::timed(histogram, [&] { mp.erase(w.keys[i]); });
+	clobber();
+}
+
+template<typename Map>
+void	findLatency(const workload& w, ft::latencyHistogram& histogram)
+{
+	Map mp;
+	buildMap(mp, w);
+	size_t hits = 0;
+	for (size_t i = 0; i < w.n; i++)
+		ft::timed(histogram, [&] { hits += mp.find(w.probes[i]) != mp.end(); });
+	if (hits > w.n)
+		std::cerr << hits;
+}
+
+typedef void	(*latencyFunction)(const workload&, ft::latencyHistogram&);
+
+struct latencyCase
+{
+	const char*		container;
+	const char*		operation;
+	bool			keyed;
+	latencyFunction	ft;
+	latencyFunction	std;
+};
+
+const latencyCase	latencyCases[] = {
+	{ "vector", "push_back", false, pushBackLatency<ftVector>, pushBackLatency<stdVector> },
+	{ "map", "insert", true, insertLatency<ftMap>, insertLatency<stdMap> },
+	{ "map", "erase", true, eraseLatency<ftMap>, eraseLatency<stdMap> },
+	{ "map", "find", true, findLatency<ftMap>, findLatency<stdMap> },
+};
+
+// one untimed run first, then every operation of REPEATS runs
+void	measureLatency(latencyFunction function, const workload& w, ft::latencyHistogram& histogram)
+{
+	function(w, histogram);
+	histogram.clear();
+	for (int r = 0; r < REPEATS; r++)
+		function(w, histogram);
+}
+
+void	printLatencyHeader()
+{
+	std::cout << std::endl << "latency in ns per call, random keys" << std::endl;
+	std::cout << std::setw(8) << "" << std::setw(12) << "" << std::setw(10) << ""
+		<< std::setw(44) << "ft" << std::setw(44) << "std" << std::endl;
+	std::cout << std::setw(8) << "type" << std::setw(12) << "operation" << std::setw(10) << "n";
+	for (int side = 0; side < 2; side++)
+		std::cout << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(14) << "max";
+	std::cout << std::endl;
+}
+
+void	printLatencySide(const ft::latencyHistogram& histogram)
+{
+	const double percents[] = { 50, 99, 99.9 };
+	for (int i = 0; i < 3; i++)
+		std::cout << std::setw(10) << histogram.percentile(percents[i]) / ft::tickClock::ticksPerNs();
+	std::cout << std::setw(14) << histogram.max() / ft::tickClock::ticksPerNs();
+}
+
+void	reportLatency(size_t maxElements)
+{
+	workload w;
+	ft::latencyHistogram ftHistogram;
+	ft::latencyHistogram stdHistogram;
+
+	printLatencyHeader();
+	for (size_t n = 1000; n <= maxElements; n *= 10)
+	{
+		buildWorkload(w, n, RANDOM);
+		for (size_t c = 0; c < sizeof(latencyCases) / sizeof(latencyCases[0]); c++)
+		{
+			const latencyCase& bench = latencyCases[c];
+			if (bench.keyed && n > MAP_MAX_ELEMENTS)
+				continue;
+			measureLatency(bench.ft, w, ftHistogram);
+			measureLatency(bench.std, w, stdHistogram);
+			std::cout << std::setw(8) << bench.container << std::setw(12) << bench.operation << std::setw(10) << n
+				<< std::fixed << std::setprecision(1);
+			printLatencySide(ftHistogram);
+			printLatencySide(stdHistogram);
+			std::cout << std::endl;
+		}
+	}
+}
+
+/******************** REPORTING ********************/
+
+struct row
+{
+	const char*		container;
+	const char*		operation;
+	distribution	dist;
+	size_t			n;
+	summary			ft;
+	summary			std;
+};
+
+summary	measure(benchFunction function, const workload& w, hardwareCounters* counters)
+{
+	stopwatch watch(counters);
+	function(w, watch);
+	watch.clear();
+	for (int r = 0; r < REPEATS; r++)
+		function(w, watch);
+	summary result = summarize(watch.results());
+	for (int e = 0; counters && e < hardwareCounters::EVENT_COUNT; e++)
+	{
+		result.counted[e] = counters->available(e);
+		result.perOp[e] = counters->total(e) / watch.counted();
+	}
+	return result;
+}
+
+void	printHeader()
+{
+	std::cout << std::setw(8) << "" << std::setw(12) << "" << std::setw(8) << "" << std::setw(10) << ""
+		<< std::setw(22) << "ft ns/op" << std::setw(22) << "std ns/op" << std::setw(22) << "Mops/s (median)" << std::endl;
+	std::cout << std::setw(8) << "type" << std::setw(12) << "operation" << std::setw(8) << "keys" << std::setw(10) << "n"
+		<< std::setw(11) << "median" << std::setw(11) << "p99" << std::setw(11) << "median" << std::setw(11) << "p99"
+		<< std::setw(11) << "ft" << std::setw(11) << "std" << std::setw(10) << "std/ft" << std::endl;
+}
+
+void	printRow(const row& r)
+{
+	std::cout << std::setw(8) << r.container << std::setw(12) << r.operation << std::setw(8) << distributionName(r.dist)
+		<< std::setw(10) << r.n << std::fixed << std::setprecision(2)
+		<< std::setw(11) << r.ft.median << std::setw(11) << r.ft.p99
+		<< std::setw(11) << r.std.median << std::setw(11) << r.std.p99
+		<< std::setw(11) << 1e3 / r.ft.median << std::setw(11) << 1e3 / r.std.median
+		<< std::setw(9) << r.std.median / r.ft.median << "x" << std::endl;
+}
+
+// one line per side under the row, when the counters ran
+void	printCounters(const char* side, const summary& s)
+{
+	bool any = false;
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(2);
+	for (int e = 0; e < hardwareCounters::EVENT_COUNT; e++)
+	{
+		if (!s.counted[e])
+			continue;
+		line << "  " << hardwareCounters::name(e) << ' ' << s.perOp[e];
+		any = true;
+	}
+	if (s.counted[hardwareCounters::CYCLES] && s.counted[hardwareCounters::INSTRUCTIONS] && s.perOp[hardwareCounters::CYCLES] > 0)
+		line << "  ipc " << s.perOp[hardwareCounters::INSTRUCTIONS] / s.perOp[hardwareCounters::CYCLES];
+	if (any)
+		std::cout << std::setw(46) << side << " per op:" << line.str() << std::endl;
+}
+
+void	writeCsv(const char* path, const ft::vector<row>& rows)
+{
+	std::ofstream out(path);
+	out << "container,operation,distribution,n,ft_median_ns,ft_p99_ns,ft_ops_per_s,std_median_ns,std_p99_ns,std_ops_per_s";
+	for (int side = 0; side < 2; side++)
+		for (int e = 0; e < hardwareCounters::EVENT_COUNT; e++)
+			out << ',' << (side ? "std_" : "ft_") << hardwareCounters::name(e) << "_per_op";
+	out << '\n' << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		const row& r = rows[i];
+		out << r.container << ',' << r.operation << ',' << distributionName(r.dist) << ',' << r.n << ','
+			<< r.ft.median << ',' << r.ft.p99 << ',' << 1e9 / r.ft.median << ','
+			<< r.std.median << ',' << r.std.p99 << ',' << 1e9 / r.std.median;
+		// counters that did not run stay empty
+		for (int side = 0; side < 2; side++)
+		{
+			const summary& s = (side ? r.std : r.ft);
+			for (int e = 0; e < hardwareCounters::EVENT_COUNT; e++)
+			{
+				out << ',';
+				if (s.counted[e])
+					out << s.perOp[e];
+			}
+		}
+		out << '\n';
+	}
+}
+
+void	writeSide(std::ofstream& out, const summary& s)
+{
+	out << "{\"median_ns\": " << s.median << ", \"p99_ns\": " << s.p99 << ", \"ops_per_s\": " << 1e9 / s.median;
+	for (int e = 0; e < hardwareCounters::EVENT_COUNT; e++)
+		if (s.counted[e])
+			out << ", \"" << hardwareCounters::name(e) << "_per_op\": " << s.perOp[e];
+	out << '}';
+}
+
+void	writeJson(const char* path, const ft::vector<row>& rows)
+{
+	std::ofstream out(path);
+	out << std::fixed << std::setprecision(3) << "[\n";
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		const row& r = rows[i];
+		out << "  {\"container\": \"" << r.container << "\", \"operation\": \"" << r.operation
+			<< "\", \"distribution\": \"" << distributionName(r.dist) << "\", \"n\": " << r.n << ", \"ft\": ";
+		writeSide(out, r.ft);
+		out << ", \"std\": ";
+		writeSide(out, r.std);
+		out << '}' << (i + 1 < rows.size() ? "," : "") << '\n';
+	}
+	out << "]\n";
+}
+
+const char*	option(const char* arg, const char* name)
+{
+	size_t length = std::strlen(name);
+	if (std::strncmp(arg, name, length) == 0 && arg[length] == '=')
+		return arg + length + 1;
+	return NULL;
+}
+
+int main(int argc, char** argv)
+{
+	size_t maxElements = MAX_ELEMENTS;
+	const char* csvPath = "bench_suite.csv";
+	const char* jsonPath = "bench_suite.json";
+	bool perf = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (option(argv[i], "--max"))
+			maxElements = std::strtoul(option(argv[i], "--max"), NULL, 10);
+		else if (option(argv[i], "--csv"))
+			csvPath = option(argv[i], "--csv");
+		else if (option(argv[i], "--json"))
+			jsonPath = option(argv[i], "--json");
+		else if (std::strcmp(argv[i], "--perf") == 0)
+			perf = true;
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--max=N] [--csv=PATH] [--json=PATH] [--perf]" << std::endl;
+			return (1);
+		}
+	}
+	hardwareCounters counters;
+	std::string reason;
+	if (perf && !counters.open(reason))
+	{
+		std::cout << "hardware counters unavailable (" << reason << "), timing only" << std::endl;
+		perf = false;
+	}
+	for (int e = 0; perf && e < hardwareCounters::EVENT_COUNT; e++)
+		if (!counters.available(e))
+			std::cout << "hardware counter " << hardwareCounters::name(e) << " unavailable" << std::endl;
+	hardwareCounters* measured = (perf ? &counters : NULL);
+	printHeader();
+	ft::vector<row> rows;
+	workload w;
+	for (size_t n = 1000; n <= maxElements; n *= 10)
+	{
+		for (int d = NONE; d <= ZIPF; d++)
+		{
+			distribution dist = static_cast<distribution>(d);
+			buildWorkload(w, n, dist == NONE ? RANDOM : dist);
+			for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+			{
+				const benchCase& bench = cases[c];
+				if (bench.keyed == (dist == NONE) || n > bench.maxElements
+					|| (dist == SORTED && n > bench.maxSortedElements))
+					continue;
+				row r;
+				r.container = bench.container;
+				r.operation = bench.operation;
+				r.dist = dist;
+				r.n = n;
+				r.ft = measure(bench.ft, w, measured);
+				r.std = measure(bench.std, w, measured);
+				printRow(r);
+				printCounters("ft", r.ft);
+				printCounters("std", r.std);
+				rows.push_back(r);
+			}
+		}
+	}
+	reportMemory(maxElements);
+	reportEmptyMaps();
+	reportLatency(maxElements);
+	writeCsv(csvPath, rows);
+	writeJson(jsonPath, rows);
+	std::cout << "wrote " << csvPath << " and " << jsonPath << std::endl;
+	return (0);
+}
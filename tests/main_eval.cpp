@@ -5,6 +5,9 @@
 #include <vector>
 #include <typeinfo>
 #include <list>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
 
 #define NODES 500000
 
@@ -17,15 +20,34 @@
 	#define TESTCASE 1
 #else
 	#include "../map.hpp"
+	#include "../map_algebra.hpp"
 	#include "../stack.hpp"
 	#include "../vector.hpp"
 	#include "../utils.hpp"
+	#include "../span.hpp"
+	#include "../cow_vector.hpp"
+	#include "../sort.hpp"
+	#include "../frozen_map.hpp"
+	#include "../snapshot.hpp"
+	#include "../mapped_map.hpp"
+	#if __cplusplus >= 201103L
+		#include "../soa_vector.hpp"
+		#include "../parallel.hpp"
+		#include "../concurrent_map.hpp"
+	#endif
 	#include <iostream>
 	#include <sstream>
 	#define TESTCASE 0
 #endif
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#if __cplusplus >= 201103L
+	#include <atomic>
+	#include <mutex>
+	#include <thread>
+#endif
 #include "AAnimal.hpp"
 #include "Cat.hpp"
 
@@ -88,6 +110,748 @@ void map_insert_test(ft::map<int, int> *mp, int min, int max)
 	}
 }
 
+void print_map(int id, const ft::map<int, int>& mp)
+{
+	std::cout << id << ". [" << mp.size() << "]";
+	for (ft::map<int, int>::const_iterator it = mp.begin(); it != mp.end(); ++it)
+		std::cout << ' ' << it->first << ':' << it->second;
+	std::cout << " |";
+	for (ft::map<int, int>::const_iterator it = mp.end(); it != mp.begin();)
+		std::cout << ' ' << (--it)->first;
+	std::cout << '\n';
+}
+
+void print_range(const int* first, const int* last)
+{
+	std::cout << " [";
+	for (; first != last; ++first)
+		std::cout << ' ' << *first;
+	std::cout << " ]";
+}
+
+// views of [first, last) cut at n: first(n), last(n), subspan(n), subspan(1, n)
+// and at(n). std has no span in C++98, so there the pointers are computed and
+// the bounds checked by hand
+void span_views(int* first, int* last, size_t n)
+{
+	std::cout << n << ':';
+#if LIB
+	size_t size = last - first;
+	if (n > size)
+		std::cout << " caught out_of_range";
+	else
+	{
+		print_range(first, first + n);
+		print_range(last - n, last);
+		print_range(first + n, last);
+	}
+	if (size < 1 || n > size - 1)
+		std::cout << " caught out_of_range";
+	else
+		print_range(first + 1, first + 1 + n);
+	if (n >= size)
+		std::cout << " caught out_of_range";
+	else
+		std::cout << ' ' << first[n];
+#else
+	ft::span<int> view(first, last);
+	try
+	{
+		ft::span<int> head = view.first(n);
+		ft::span<int> tail = view.last(n);
+		ft::span<int> rest = view.subspan(n);
+		print_range(head.data(), head.data() + head.size());
+		print_range(&*tail.begin(), &*tail.begin() + tail.size());
+		print_range(rest.data(), rest.data() + rest.size());
+	}
+	catch (std::out_of_range&)
+	{
+		std::cout << " caught out_of_range";
+	}
+	try
+	{
+		ft::span<int> middle = view.subspan(1, n);
+		print_range(middle.data(), middle.data() + middle.size());
+	}
+	catch (std::out_of_range&)
+	{
+		std::cout << " caught out_of_range";
+	}
+	try
+	{
+		int value = view.at(n);
+		std::cout << ' ' << value;
+	}
+	catch (std::out_of_range&)
+	{
+		std::cout << " caught out_of_range";
+	}
+#endif
+	std::cout << std::endl;
+}
+
+// std::vector does not share its buffer: the cow_vector use counts are
+// checked on the ft side and the expected counts printed on the std side
+#if LIB
+typedef std::vector<int> int_cow;
+#else
+typedef ft::cow_vector<int> int_cow;
+#endif
+
+void print_cow(int id, const int_cow& v, size_t expectedUses)
+{
+	std::cout << id << ". ";
+	for (size_t i = 0; i < v.size(); ++i)
+		std::cout << ' ' << v[i];
+#if LIB
+	std::cout << " (" << expectedUses << ')';
+#else
+	std::cout << " (" << v.use_count() << ')';
+	(void)expectedUses;
+#endif
+	std::cout << std::endl;
+}
+
+void cow_set(int_cow& v, size_t idx, int val)
+{
+#if LIB
+	v[idx] = val;
+#else
+	v.set(idx, val);
+#endif
+}
+
+// radix_sort is stable: the std side uses std::stable_sort on the same key
+typedef ft::pair<long long, int> keyed_row;
+
+bool row_key_less(const keyed_row& lhs, const keyed_row& rhs)
+{
+	return lhs.first < rhs.first;
+}
+
+struct low_byte
+{
+	typedef unsigned char result_type;
+
+	unsigned char operator()(int value) const
+	{
+		return value & 0xFF;
+	}
+};
+
+bool low_byte_less(int lhs, int rhs)
+{
+	return low_byte()(lhs) < low_byte()(rhs);
+}
+
+void sort_radix(ft::vector<int>& vec)
+{
+#if LIB
+	std::stable_sort(vec.begin(), vec.end());
+#else
+	ft::radix_sort(vec.begin(), vec.end());
+#endif
+}
+
+void sort_radix(ft::vector<keyed_row>& rows)
+{
+#if LIB
+	std::stable_sort(rows.begin(), rows.end(), row_key_less);
+#else
+	ft::radix_sort(rows.begin(), rows.end());
+#endif
+}
+
+void sort_radix_low_byte(ft::vector<int>& vec)
+{
+#if LIB
+	std::stable_sort(vec.begin(), vec.end(), low_byte_less);
+#else
+	ft::radix_sort(vec.begin(), vec.end(), low_byte());
+#endif
+}
+
+#if __cplusplus >= 201103L
+// a lambda key has no result_type
+void sort_radix_by_last_digit(ft::vector<keyed_row>& rows)
+{
+#if LIB
+	std::stable_sort(rows.begin(), rows.end(), [](const keyed_row& lhs, const keyed_row& rhs)
+	{
+		return lhs.second % 10 < rhs.second % 10;
+	});
+#else
+	ft::radix_sort(rows.begin(), rows.end(), [](const keyed_row& row) { return row.second % 10; });
+#endif
+}
+#endif
+
+bool keyed_row_less_by_mod(const keyed_row& lhs, const keyed_row& rhs)
+{
+	return lhs.first % 7 < rhs.first % 7;
+}
+
+template<typename Compare>
+void sort_ints(ft::vector<int>& vec, Compare comp)
+{
+#if LIB
+	std::sort(vec.begin(), vec.end(), comp);
+#else
+	ft::sort(vec.begin(), vec.end(), comp);
+#endif
+}
+
+void stable_sort_rows(ft::vector<keyed_row>& rows)
+{
+#if LIB
+	std::stable_sort(rows.begin(), rows.end(), keyed_row_less_by_mod);
+#else
+	ft::stable_sort(rows.begin(), rows.end(), keyed_row_less_by_mod);
+#endif
+}
+
+#if __cplusplus >= 201103L
+// the std side keeps the same rows as a vector of tuples
+typedef std::tuple<int, double, char> soa_row;
+#if LIB
+typedef std::vector<soa_row> soa_rows;
+#else
+typedef ft::soa_vector<int, double, char> soa_rows;
+#endif
+
+void print_rows(int id, const soa_rows& rows)
+{
+	std::cout << id << ". [" << rows.size() << "]";
+	for (size_t i = 0; i < rows.size(); ++i)
+	{
+		soa_row row = rows[i];
+		std::cout << ' ' << std::get<0>(row) << '/' << std::get<1>(row) << '/' << std::get<2>(row);
+	}
+	std::cout << std::endl;
+}
+
+// the std side runs the serial algorithms; the ft side a small pool with
+// a grain low enough that the ranges are really split into tasks
+#if LIB
+template<typename Compare>
+void par_sort(ft::vector<int>& vec, Compare comp)
+{
+	std::sort(vec.begin(), vec.end(), comp);
+}
+
+template<typename T, typename BinaryOperation>
+T par_reduce(const ft::vector<int>& vec, T init, BinaryOperation op)
+{
+	for (size_t i = 0; i < vec.size(); i++)
+		init = op(init, vec[i]);
+	return init;
+}
+#else
+ft::parallel::options par_options()
+{
+	static ft::parallel::threadPool pool(4);
+	return ft::parallel::options(&pool, 1000, 2000);
+}
+
+template<typename Compare>
+void par_sort(ft::vector<int>& vec, Compare comp)
+{
+	ft::parallel::sort(vec.begin(), vec.end(), comp, par_options());
+}
+
+template<typename T, typename BinaryOperation>
+T par_reduce(const ft::vector<int>& vec, T init, BinaryOperation op)
+{
+	return ft::parallel::reduce(vec.begin(), vec.end(), init, op, par_options());
+}
+#endif
+
+long long max_of(long long lhs, long long rhs)
+{
+	return lhs < rhs ? rhs : lhs;
+}
+
+// the std side locks a std::map around every access
+#if LIB
+class concurrent_int_map
+{
+public:
+	class reader
+	{
+	public:
+		explicit reader(const concurrent_int_map& owner)
+			: owner(owner) { }
+
+		bool find(int k, std::string& value) const
+		{
+			std::lock_guard<std::mutex> hold(owner.lock);
+			std::map<int, std::string>::const_iterator it = owner.entries.find(k);
+			if (it == owner.entries.end())
+				return false;
+			value = it->second;
+			return true;
+		}
+
+	private:
+		const concurrent_int_map&	owner;
+	};
+
+	bool insert(const std::pair<int, std::string>& val)
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		return entries.insert(val).second;
+	}
+
+	bool insert_or_assign(const std::pair<int, std::string>& val)
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		bool inserted = !entries.count(val.first);
+		entries[val.first] = val.second;
+		return inserted;
+	}
+
+	size_t erase(int k)
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		return entries.erase(k);
+	}
+
+	void reclaim() { }
+
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		return entries.size();
+	}
+
+private:
+	mutable std::mutex				lock;
+	std::map<int, std::string>		entries;
+};
+#else
+typedef ft::concurrent_map<int, std::string> concurrent_int_map;
+#endif
+
+std::string concurrent_value(int k, int version)
+{
+	std::ostringstream value;
+	value << k << ':' << version;
+	return value.str();
+}
+
+// looks key up in {10, 5, 20, 15} while erased is erased, right after the
+// reader compared key with the root: erasing 10 moves 15 up while a reader
+// is on its way down to it, past 20. The std side erases
+// before the lookup, the order the lock would impose
+#if LIB
+std::string concurrent_lookup_across_erase(int key, int erased)
+{
+	const int keys[] = { 10, 5, 20, 15 };
+	concurrent_int_map table;
+	for (int i = 0; i < 4; i++)
+		table.insert(std::make_pair(keys[i], concurrent_value(keys[i], 0)));
+	table.erase(erased);
+	concurrent_int_map::reader r(table);
+	std::string value;
+	return r.find(key, value) ? value : "missing";
+}
+#else
+// runs the pending writer the first time the reader compares
+struct trapped_less
+{
+	std::function<void()>*	trap;
+
+	bool operator()(int lhs, int rhs) const
+	{
+		if (*trap)
+		{
+			std::function<void()> writer;
+			writer.swap(*trap);
+			writer();
+		}
+		return lhs < rhs;
+	}
+};
+
+std::string concurrent_lookup_across_erase(int key, int erased)
+{
+	const int keys[] = { 10, 5, 20, 15 };
+	std::function<void()> trap;
+	ft::concurrent_map<int, std::string, trapped_less> table(trapped_less{ &trap });
+	for (int i = 0; i < 4; i++)
+		table.insert(ft::make_pair(keys[i], concurrent_value(keys[i], 0)));
+	ft::concurrent_map<int, std::string, trapped_less>::reader r(table);
+	trap = [&table, erased]() { table.erase(erased); };
+	std::string value;
+	return r.find(key, value) ? value : "missing";
+}
+#endif
+#endif
+
+// std::map has no order statistics: count and step with std::distance/advance
+size_t map_rank(const ft::map<int, int>& mp, int key)
+{
+#if LIB
+	return std::distance(mp.begin(), mp.lower_bound(key));
+#else
+	return mp.rank(key);
+#endif
+}
+
+ft::map<int, int>::const_iterator map_select(const ft::map<int, int>& mp, size_t i)
+{
+#if LIB
+	ft::map<int, int>::const_iterator it = mp.begin();
+	std::advance(it, std::min(i, mp.size()));
+	return it;
+#else
+	return mp.select(i);
+#endif
+}
+
+ft::map<int, int>::iterator map_step(ft::map<int, int>::iterator it, int n)
+{
+#if LIB
+	std::advance(it, n);
+	return it;
+#else
+	return it + n;
+#endif
+}
+
+// std::map has no batched lookups: one find/lower_bound per key
+void map_sorted_lookups(ft::map<int, int>& mp, const ft::vector<int>& keys)
+{
+	ft::vector<ft::map<int, int>::iterator> found(keys.size());
+	ft::vector<ft::map<int, int>::iterator> bounds(keys.size());
+#if LIB
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		found[i] = mp.find(keys[i]);
+		bounds[i] = mp.lower_bound(keys[i]);
+	}
+#else
+	mp.find_sorted(keys.begin(), keys.end(), found.begin());
+	mp.lower_bound_sorted(keys.begin(), keys.end(), bounds.begin());
+#endif
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		std::cout << ' ' << keys[i] << ':';
+		if (found[i] == mp.end())
+			std::cout << '-';
+		else
+			std::cout << found[i]->second;
+		std::cout << '/';
+		if (bounds[i] == mp.end())
+			std::cout << "end";
+		else
+			std::cout << bounds[i]->first;
+	}
+	std::cout << std::endl;
+}
+
+// std::map has no find_batch: look the keys up one at a time
+void map_batch_lookups(const ft::map<int, int>& mp, const ft::vector<int>& keys)
+{
+	ft::vector<ft::map<int, int>::const_iterator> found(keys.size());
+#if LIB
+	for (size_t i = 0; i < keys.size(); i++)
+		found[i] = mp.find(keys[i]);
+#else
+	if (!keys.empty())
+		mp.find_batch(&keys[0], keys.size(), &found[0]);
+#endif
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		std::cout << ' ' << keys[i] << ':';
+		if (found[i] == mp.end())
+			std::cout << '-';
+		else
+			std::cout << found[i]->second;
+	}
+	std::cout << std::endl;
+}
+
+// std::map has no freeze: the std side looks up in a copy of the map
+#if LIB
+typedef std::map<int, int> frozen_int_map;
+#else
+typedef ft::frozen_map<int, int> frozen_int_map;
+#endif
+
+frozen_int_map freeze_map(const ft::map<int, int>& mp)
+{
+#if LIB
+	return mp;
+#else
+	return mp.freeze();
+#endif
+}
+
+template<typename Frozen>
+void print_frozen_lookups(const Frozen& frozen, const ft::vector<int>& keys)
+{
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		typename Frozen::const_iterator found = frozen.find(keys[i]);
+		typename Frozen::const_iterator lower = frozen.lower_bound(keys[i]);
+		typename Frozen::const_iterator upper = frozen.upper_bound(keys[i]);
+		std::cout << ' ' << keys[i] << ':' << frozen.count(keys[i]) << '/';
+		if (found == frozen.end())
+			std::cout << '-';
+		else
+			std::cout << found->second;
+		std::cout << '/' << (lower == frozen.end() ? -1 : lower->first);
+		std::cout << '/' << (upper == frozen.end() ? -1 : upper->first);
+	}
+	std::cout << std::endl;
+}
+
+// std::map cannot be mapped from a file: the std side looks up in a copy
+#if LIB
+typedef std::map<int, int> mapped_int_map;
+#else
+typedef ft::mapped_map<int, int> mapped_int_map;
+#endif
+
+// saves mp to a new file and maps it into table
+void map_from_file(const ft::map<int, int>& mp, mapped_int_map& table)
+{
+#if LIB
+	table = mp;
+#else
+	char path[] = "/tmp/ft_mapped_map_XXXXXX";
+	int fd = mkstemp(path);
+	close(fd);
+	ft::save_mapped(path, mp);
+	table.open(path);
+	unlink(path);
+#endif
+}
+
+// same through an open file
+void map_from_fd(const ft::map<int, int>& mp, mapped_int_map& table)
+{
+#if LIB
+	table = mp;
+#else
+	FILE* file = tmpfile();
+	ft::save_mapped(fileno(file), mp);
+	table.open(fileno(file));
+	fclose(file);
+#endif
+}
+
+// std containers have no snapshots: the std side copies what a save and a
+// load give back
+template<typename Container>
+void snapshot_copy(const Container& from, Container& to)
+{
+#if LIB
+	to = from;
+#else
+	std::stringstream bytes;
+	ft::save(bytes, from);
+	ft::load(bytes, to);
+#endif
+}
+
+// two snapshots back to back in one file, loaded back in order
+void snapshot_copy_file(const ft::vector<int>& vec, const ft::map<int, std::string>& mp,
+	ft::vector<int>& vecCopy, ft::map<int, std::string>& mapCopy)
+{
+#if LIB
+	vecCopy = vec;
+	mapCopy = mp;
+#else
+	FILE* file = tmpfile();
+	int fd = fileno(file);
+	ft::save(fd, mp);
+	ft::save(fd, vec);
+	lseek(fd, 0, SEEK_SET);
+	ft::load(fd, mapCopy);
+	ft::load(fd, vecCopy);
+	fclose(file);
+#endif
+}
+
+// loads a snapshot missing its last byte: the load fails and leaves the
+// container empty
+template<typename Container>
+bool snapshot_load_truncated(const Container& from, Container& to)
+{
+#if LIB
+	(void)from;
+	to.clear();
+	return false;
+#else
+	std::stringstream bytes;
+	ft::save(bytes, from);
+	std::string cut = bytes.str();
+	cut.resize(cut.size() - 1);
+	std::istringstream in(cut);
+	try
+	{
+		ft::load(in, to);
+	}
+	catch (ft::snapshot_error&)
+	{
+		return false;
+	}
+	return true;
+#endif
+}
+
+// std::map has no stats: the std side rebuilds the shape of the unbalanced
+// tree ft::map grows from the same insertions. A new key hangs below its
+// predecessor or its successor, whichever is deeper
+void print_map_stats(const ft::map<int, int>& mp, const ft::vector<int>& inserted)
+{
+	size_t count;
+	size_t balanced = 0;
+	double average;
+	double comparisons;
+	ft::vector<size_t> histogram;
+#if LIB
+	(void)mp;
+	std::map<int, size_t> depthOf;
+	size_t depthSum = 0;
+	for (size_t i = 0; i < inserted.size(); i++)
+	{
+		if (depthOf.count(inserted[i]))
+			continue;
+		std::map<int, size_t>::iterator next = depthOf.lower_bound(inserted[i]);
+		size_t depth = 0;
+		if (next != depthOf.end())
+			depth = next->second + 1;
+		if (next != depthOf.begin())
+			depth = std::max(depth, (--next)->second + 1);
+		depthOf[inserted[i]] = depth;
+		if (depth == histogram.size())
+			histogram.push_back(0);
+		++histogram[depth];
+		depthSum += depth;
+	}
+	count = depthOf.size();
+	average = (count ? static_cast<double>(depthSum) / count : 0);
+	comparisons = (count ? average + 1 : 0);
+	for (size_t levels = count; levels; levels >>= 1)
+		++balanced;
+#else
+	(void)inserted;
+	ft::map_stats stats = mp.stats();
+	count = stats.node_count;
+	balanced = stats.balanced_height;
+	average = stats.average_depth;
+	comparisons = stats.average_comparisons;
+	histogram = stats.depth_histogram;
+#endif
+	// a stream of its own, so that std::fixed does not stick to std::cout
+	std::ostringstream depths;
+	depths << std::fixed << std::setprecision(3) << average << ' ' << comparisons;
+	std::cout << count << ' ' << histogram.size() << ' ' << (histogram.empty() ? 0 : histogram.size() - 1) << ' ' << balanced
+		<< ' ' << depths.str() << std::endl;
+	for (size_t depth = 0; depth < histogram.size(); depth++)
+		std::cout << ' ' << histogram[depth];
+	std::cout << std::endl;
+}
+
+// std::map has no extract_range: copy the range out and erase it
+ft::map<int, int> map_extract_range(ft::map<int, int>& mp, int lo, int hi)
+{
+#if LIB
+	ft::map<int, int> extracted(mp.lower_bound(lo), mp.lower_bound(hi));
+	mp.erase(mp.lower_bound(lo), mp.lower_bound(hi));
+	return extracted;
+#else
+	return mp.extract_range(lo, hi);
+#endif
+}
+
+void map_extract_range(ft::map<int, int>& mp, int lo, int hi, ft::map<int, int>& into)
+{
+#if LIB
+	ft::map<int, int>(mp.lower_bound(lo), mp.lower_bound(hi)).swap(into);
+	mp.erase(mp.lower_bound(lo), mp.lower_bound(hi));
+#else
+	mp.extract_range(lo, hi, into);
+#endif
+}
+
+// std::map has no set algebra: the same result built by hand, values from
+// a. op is 0 for union, 1 for intersection, 2 for difference; consuming
+// empties a and b
+void map_algebra_into(ft::map<int, int>& a, ft::map<int, int>& b, int op, bool consuming, ft::map<int, int>& out)
+{
+#if LIB
+	ft::map<int, int> result;
+	if (op == 0)
+	{
+		result = a;
+		result.insert(b.begin(), b.end());
+	}
+	for (ft::map<int, int>::iterator it = a.begin(); op != 0 && it != a.end(); ++it)
+		if ((b.count(it->first) != 0) == (op == 1))
+			result.insert(*it);
+	if (consuming)
+	{
+		a.clear();
+		b.clear();
+	}
+	result.swap(out);
+#else
+	if (op == 0)
+		consuming ? ft::map_union(a, b, ft::consume, out) : ft::map_union(a, b, out);
+	else if (op == 1)
+		consuming ? ft::map_intersection(a, b, ft::consume, out) : ft::map_intersection(a, b, out);
+	else
+		consuming ? ft::map_difference(a, b, ft::consume, out) : ft::map_difference(a, b, out);
+#endif
+}
+
+// std::map has no node handles in C++98: the value is copied over instead.
+// Prints 1 when the element moved, 0 when the key was taken (the element is
+// dropped with its handle) and - when from has no such key
+void map_move_node(ft::map<int, int>& from, ft::map<int, int>& to, int key)
+{
+#if LIB
+	ft::map<int, int>::iterator it = from.find(key);
+	if (it == from.end())
+	{
+		std::cout << '-';
+		return;
+	}
+	std::cout << to.insert(*it).second;
+	from.erase(it);
+#else
+	ft::map<int, int>::node_type nh = from.extract(key);
+	if (nh.empty())
+	{
+		std::cout << '-';
+		return;
+	}
+	ft::map<int, int>::insert_return_type result = to.insert(nh);
+	std::cout << result.inserted;
+	if (!result.inserted && result.node.key() != key)
+		std::cout << '!';
+#endif
+}
+
+void map_merge(ft::map<int, int>& to, ft::map<int, int>& from)
+{
+#if LIB
+	for (ft::map<int, int>::iterator it = from.begin(); it != from.end();)
+	{
+		if (to.insert(*it).second)
+			from.erase(it++);
+		else
+			++it;
+	}
+#else
+	to.merge(from);
+#endif
+}
+
 int main(int argc, char** argv) {
 	if (argc != 2)
 	{
@@ -117,6 +881,326 @@ int main(int argc, char** argv) {
 		std::cout << vec1.size() << " | " << vec2.size() << std::endl;
 	}
 
+	// **************************************************
+	{
+		outputTitle("Vector: Input Iterator Range");
+		std::istringstream input("1 2 3 4 5 6 7 8 9 10 11 12");
+		ft::vector<int> vec((std::istream_iterator<int>(input)), std::istream_iterator<int>());
+		print(1, vec);
+
+		std::istringstream assignInput("42 43 44");
+		vec.assign(std::istream_iterator<int>(assignInput), std::istream_iterator<int>());
+		print(2, vec);
+
+		std::istringstream endInput("5 6 7 8 9");
+		vec.insert(vec.end(), std::istream_iterator<int>(endInput), std::istream_iterator<int>());
+		print(3, vec);
+
+		std::istringstream midInput("-1 -2");
+		vec.insert(vec.begin() + 1, std::istream_iterator<int>(midInput), std::istream_iterator<int>());
+		print(4, vec);
+
+		ft::vector<int> copy(vec.begin(), vec.end());
+		copy.reserve(20);
+		copy.insert(copy.begin() + 8, vec.begin(), vec.begin() + 4);
+		copy.insert(copy.begin() + 2, vec.begin(), vec.begin() + 4);
+		print(5, copy);
+	}
+
+	// **************************************************
+	{
+		outputTitle("Vector: Comparison Operators");
+		ft::vector<char> chars1(1000, 'a');
+		ft::vector<char> chars2(chars1);
+		std::cout << (chars1 == chars2) << (chars1 < chars2) << (chars1 <= chars2) << std::endl;
+		chars2[700] = -3;
+		std::cout << (chars1 == chars2) << (chars1 < chars2) << (chars1 > chars2) << std::endl;
+		chars2.pop_back();
+		chars2[700] = 'a';
+		std::cout << (chars1 == chars2) << (chars1 < chars2) << (chars1 > chars2) << std::endl;
+
+		ft::vector<int> ints1;
+		for (int i = 0; i < 777; i++)
+			ints1.push_back(i * 1000);
+		ft::vector<int> ints2(ints1);
+		std::cout << (ints1 == ints2) << (ints1 < ints2) << (ints1 >= ints2) << std::endl;
+		ints2[513] = 513 * 1000 + 256;
+		std::cout << (ints1 == ints2) << (ints1 < ints2) << (ints1 > ints2) << std::endl;
+		ints2[300] = -1;
+		std::cout << (ints1 == ints2) << (ints1 < ints2) << (ints1 > ints2) << std::endl;
+		ft::vector<int> empty;
+		std::cout << (empty == ints1) << (empty < ints1) << (ints1 < empty) << std::endl;
+	}
+
+	// **************************************************
+	{
+		outputTitle("Sort: Radix Sort");
+		ft::vector<int> small, large, bytes;
+		for (int i = 0; i < 30; i++)
+			small.push_back(rand() % 200 - 100);
+		for (int i = 0; i < 5000; i++)
+			large.push_back(rand() - RAND_MAX / 2);
+		for (int i = 0; i < 100; i++)
+			bytes.push_back(rand() % 5000);
+		sort_radix(small);
+		print(1, small);
+		sort_radix(large);
+		bool sorted = true;
+		for (size_t i = 1; i < large.size(); i++)
+			sorted = sorted && large[i - 1] <= large[i];
+		std::cout << sorted << ' ' << large.front() << ' ' << large[2500] << ' ' << large.back() << std::endl;
+		sort_radix_low_byte(bytes);
+		print(2, bytes);
+		ft::vector<keyed_row> rows;
+		for (int i = 0; i < 200; i++)
+			rows.push_back(keyed_row((rand() % 21 - 10) * 10000000000LL, i));
+		sort_radix(rows);
+		for (size_t i = 0; i < rows.size(); i++)
+			std::cout << ' ' << rows[i].first / 10000000000LL << ':' << rows[i].second;
+		std::cout << std::endl;
+#if __cplusplus >= 201103L
+		sort_radix_by_last_digit(rows);
+		for (size_t i = 0; i < rows.size(); i++)
+			std::cout << ' ' << rows[i].second;
+		std::cout << std::endl;
+#endif
+	}
+
+	// **************************************************
+	{
+		outputTitle("Sort: Sort and Stable Sort");
+		ft::vector<int> random, ascending, descending, few;
+		for (int i = 0; i < 3000; i++)
+		{
+			random.push_back(rand() % 100000 - 50000);
+			ascending.push_back(i * 3);
+			descending.push_back(-i);
+			few.push_back(rand() % 4);
+		}
+		sort_ints(random, std::less<int>());
+		sort_ints(ascending, std::greater<int>());
+		sort_ints(descending, std::less<int>());
+		sort_ints(few, std::greater<int>());
+		for (size_t i = 0; i < random.size(); i += 300)
+			std::cout << ' ' << random[i] << '/' << ascending[i] << '/' << descending[i] << '/' << few[i];
+		std::cout << std::endl;
+		bool sorted = true;
+		for (size_t i = 1; i < random.size(); i++)
+			sorted = sorted && random[i - 1] <= random[i] && ascending[i - 1] >= ascending[i] && few[i - 1] >= few[i];
+		std::cout << sorted << std::endl;
+		ft::vector<int> tiny(random.begin() + 5, random.begin() + 25);
+		std::reverse(tiny.begin(), tiny.end());
+		tiny.push_back(tiny.front());
+		sort_ints(tiny, std::less<int>());
+		print(1, tiny);
+		ft::vector<keyed_row> rows;
+		for (int i = 0; i < 100; i++)
+			rows.push_back(keyed_row(rand() % 1000, i));
+		stable_sort_rows(rows);
+		for (size_t i = 0; i < rows.size(); i++)
+			std::cout << ' ' << rows[i].first % 7 << ':' << rows[i].second;
+		std::cout << std::endl;
+	}
+
+	// **************************************************
+	{
+		outputTitle("Span: Subviews");
+		int values[12];
+		for (int i = 0; i < 12; i++)
+			values[i] = rand() % 100;
+		for (size_t n = 0; n <= 13; n += 3)
+			span_views(values, values + 12, n);
+		span_views(values + 4, values + 4, 0);
+		span_views(values + 4, values + 5, 1);
+		ft::vector<int> vec(values, values + 12);
+		span_views(&vec[0] + 2, &vec[0] + 9, 7);
+	}
+
+	// **************************************************
+	{
+		outputTitle("Cow Vector: Detach");
+		int_cow first;
+		for (int i = 0; i < 8; i++)
+			first.push_back(rand() % 100);
+		int_cow second(first);
+		print_cow(1, first, 2);
+		cow_set(first, 0, -1);
+		print_cow(2, first, 1);
+		print_cow(3, second, 1);
+		int_cow third(second);
+		print_cow(4, third, 2);
+		int& ref = second[3];
+		int_cow fourth(second);
+		ref = 777;
+		print_cow(5, second, 1);
+		print_cow(6, third, 1);
+		print_cow(7, fourth, 1);
+		int_cow::iterator it = fourth.begin() + 5;
+		int_cow fifth;
+		fifth = fourth;
+		*it = 555;
+		print_cow(8, fourth, 1);
+		print_cow(9, fifth, 1);
+		fourth.assign(4, 3);
+		int_cow sixth(fourth);
+		cow_set(sixth, 1, 4);
+		print_cow(10, fourth, 1);
+		print_cow(11, sixth, 1);
+		int_cow seventh(fourth);
+		fourth.clear();
+		print_cow(12, fourth, 1);
+		print_cow(13, seventh, 1);
+		// references die when the buffer moves: it can be shared again
+		int_cow eighth(4, 1);
+		eighth[0] = 2;
+		int_cow ninth(eighth);
+		print_cow(14, eighth, 1);
+		eighth.reserve(eighth.capacity() + 1);
+		int_cow tenth(eighth);
+		print_cow(15, eighth, 2);
+		ninth[1] = 3;
+		ninth.swap(seventh);
+		int_cow eleventh(seventh);
+		print_cow(16, seventh, 2);
+	}
+
+#if __cplusplus >= 201103L
+	// **************************************************
+	{
+		outputTitle("Soa Vector: Row Round-Trips");
+		soa_rows rows;
+		for (int i = 0; i < 20; i++)
+			rows.push_back(soa_row(rand() % 100, (rand() % 1000) / 8.0, 'a' + rand() % 26));
+		print_rows(1, rows);
+		rows[3] = soa_row(-3, 0.5, 'Z');
+		rows[5] = rows[7];
+		rows.pop_back();
+		print_rows(2, rows);
+		soa_rows copy(rows);
+		copy[0] = soa_row(0, 0.0, 'A');
+		rows.swap(copy);
+		print_rows(3, rows);
+		print_rows(4, copy);
+		soa_rows assigned;
+		assigned.reserve(3);
+		assigned = copy;
+		assigned.push_back(soa_row(42, 4.25, 'q'));
+		print_rows(5, assigned);
+		try
+		{
+			soa_row row = assigned.at(assigned.size());
+			std::cout << std::get<0>(row) << std::endl;
+		}
+		catch (std::out_of_range&)
+		{
+			std::cout << "caught out_of_range" << std::endl;
+		}
+		assigned.clear();
+		print_rows(6, assigned);
+	}
+
+	// **************************************************
+	{
+		outputTitle("Parallel: Sort and Reduce");
+		ft::vector<int> values;
+		for (int i = 0; i < 100000; i++)
+			values.push_back(rand() % 50000 - 25000);
+		std::cout << par_reduce(values, 0LL, std::plus<long long>()) << ' ';
+		std::cout << par_reduce(values, -100000LL, max_of) << std::endl;
+		ft::vector<int> ascending(values);
+		par_sort(ascending, std::less<int>());
+		ft::vector<int> descending(values);
+		par_sort(descending, std::greater<int>());
+		for (size_t i = 0; i < values.size(); i += 4999)
+			std::cout << ' ' << ascending[i] << '/' << descending[i];
+		std::cout << std::endl;
+		bool sorted = true;
+		for (size_t i = 1; i < values.size(); i++)
+			sorted = sorted && ascending[i - 1] <= ascending[i] && descending[i - 1] >= descending[i];
+		std::cout << sorted << ' ' << par_reduce(ascending, 0LL, std::plus<long long>()) << std::endl;
+		ft::vector<int> few(values.begin(), values.begin() + 10);
+		par_sort(few, std::less<int>());
+		print(1, few);
+		ft::vector<int> none;
+		par_sort(none, std::less<int>());
+		std::cout << none.size() << ' ' << par_reduce(none, 7LL, std::plus<long long>()) << std::endl;
+	}
+
+	// **************************************************
+	{
+		outputTitle("Concurrent Map: Readers While Writing");
+		// the even keys always hold k:0, the writer keeps replacing them;
+		// the odd keys come and go
+		concurrent_int_map table;
+		for (int k = 0; k < 200; k += 2)
+			table.insert(ft::make_pair(k, concurrent_value(k, 0)));
+		std::atomic<bool> done(false);
+		std::vector<long> misses(4, 0);
+		std::vector<long> wrong(4, 0);
+		std::vector<std::thread> readers;
+		for (int t = 0; t < 4; t++)
+			readers.push_back(std::thread([&table, &done, &misses, &wrong, t]()
+			{
+				concurrent_int_map::reader r(table);
+				unsigned state = t + 1;
+				std::string value;
+				do
+				{
+					for (int i = 0; i < 100; i++)
+					{
+						state = state * 1103515245 + 12345;
+						int k = (state >> 16) % 200;
+						if (!r.find(k, value))
+							misses[t] += (k % 2 == 0);
+						else if (atoi(value.c_str()) != k || (k % 2 == 0 && value != concurrent_value(k, 0)))
+							++wrong[t];
+					}
+				}
+				while (!done.load());
+			}));
+		int inserted = 0;
+		int erased = 0;
+		for (int i = 1; i <= 20000; i++)
+		{
+			int k = rand() % 200;
+			int op = rand() % 3;
+			if (k % 2 == 0)
+				table.insert_or_assign(ft::make_pair(k, concurrent_value(k, 0)));
+			else if (op == 0)
+				erased += table.erase(k);
+			else if (op == 1)
+				inserted += table.insert_or_assign(ft::make_pair(k, concurrent_value(k, i)));
+			else
+				inserted += table.insert(ft::make_pair(k, concurrent_value(k, i)));
+		}
+		done.store(true);
+		for (size_t t = 0; t < readers.size(); t++)
+			readers[t].join();
+		for (int t = 0; t < 4; t++)
+			std::cout << ' ' << misses[t] << '/' << wrong[t];
+		std::cout << std::endl;
+		table.reclaim();
+		std::cout << table.size() << ' ' << inserted << ' ' << erased << std::endl;
+		concurrent_int_map::reader r(table);
+		std::string value;
+		for (int k = 1; k < 200; k += 2)
+			if (r.find(k, value))
+				std::cout << ' ' << value;
+		std::cout << std::endl;
+	}
+
+	// **************************************************
+	{
+		outputTitle("Concurrent Map: Lookup Across Erase");
+		const int keys[] = { 15, 20, 5, 13 };
+		for (int i = 0; i < 4; i++)
+			std::cout << ' ' << concurrent_lookup_across_erase(keys[i], 10);
+		std::cout << std::endl;
+		std::cout << ' ' << concurrent_lookup_across_erase(15, 20);
+		std::cout << ' ' << concurrent_lookup_across_erase(15, 15) << std::endl;
+	}
+
+#endif
 	// **************************************************
 	{
 		outputTitle("Map: Balanced Input");
@@ -159,6 +1243,294 @@ int main(int argc, char** argv) {
 			std::cerr << "FT (random tree) elapsed time: " << elapsedTime << "ms\n";
 	}
 	// **************************************************
+	{
+		outputTitle("Map: Swap");
+		ft::vector<ft::map<int, int> > maps(3);
+		for (int i = 0; i < 60; i++)
+			maps[i % 2][rand() % 100] = i;
+		ft::map<int, int>::iterator first = maps[0].begin();
+		ft::map<int, int>::iterator last = --maps[0].end();
+		maps[0].swap(maps[2]);
+		std::swap(maps[1], maps[2]);
+		// the iterators now walk the map the elements went to
+		for (ft::map<int, int>::iterator it = first; it != maps[1].end(); ++it)
+			std::cout << ' ' << it->first;
+		std::cout << " | " << last->first << ' ' << (++last == maps[1].end()) << std::endl;
+		for (size_t i = 0; i < maps.size(); i++)
+			print_map(static_cast<int>(i), maps[i]);
+		maps[0].swap(maps[0]);
+		maps[2].insert(ft::make_pair(-1, -1));
+		maps[1].clear();
+		maps[1].swap(maps[2]);
+		for (size_t i = 0; i < maps.size(); i++)
+			print_map(static_cast<int>(i), maps[i]);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Rank, Select and Distance");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 1000; i++)
+			mp.insert(ft::make_pair(rand() % 5000, i));
+		for (int k = -1; k <= 5000; k += 250)
+			std::cout << ' ' << map_rank(mp, k);
+		std::cout << std::endl;
+		for (size_t i = 0; i <= mp.size(); i += 97)
+			std::cout << ' ' << map_select(mp, i)->first;
+		std::cout << ' ' << (map_select(mp, mp.size()) == mp.end()) << (map_select(mp, mp.size() + 5) == mp.end()) << std::endl;
+		ft::map<int, int>::iterator mid = mp.lower_bound(2500);
+		std::cout << map_step(mid, 10)->first << ' ' << map_step(mid, -10)->first << ' ' << map_step(mp.begin(), mp.size() - 1)->first;
+		std::cout << ' ' << (map_step(mp.begin(), mp.size()) == mp.end()) << (map_step(mp.end(), -static_cast<int>(mp.size())) == mp.begin()) << std::endl;
+		for (int k = 0; k < 5000; k += 625)
+		{
+			ft::map<int, int>::iterator it = mp.lower_bound(k);
+			std::cout << ' ' << ft::distance(mp.begin(), it) << '/' << ft::distance(it, mp.end());
+			std::cout << ':' << (ft::distance(mp.begin(), it) == std::distance(mp.begin(), it));
+		}
+		std::cout << ' ' << ft::distance(mp.begin(), mp.end()) << ' ' << ft::distance(mp.end(), mp.end()) << std::endl;
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Sorted Batch Lookups");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 500; i++)
+			mp.insert(ft::make_pair(rand() % 2000, i));
+		ft::vector<int> keys;
+		for (int i = -3; i < 2010; i += 1 + rand() % 40)
+			keys.push_back(i);
+		map_sorted_lookups(mp, keys);
+		ft::vector<int> repeated(5, keys[3]);
+		repeated.push_back(keys[1]);
+		repeated.push_back(2500);
+		repeated.push_back(-1);
+		map_sorted_lookups(mp, repeated);
+		ft::map<int, int> empty;
+		map_sorted_lookups(empty, repeated);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Batched Lookups");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 2000; i++)
+			mp.insert(ft::make_pair(rand() % 5000, i));
+		ft::vector<int> keys;
+		for (int i = 0; i < 100; i++)
+			keys.push_back(rand() % 5100 - 50);
+		map_batch_lookups(mp, keys);
+		ft::vector<int> few(3, keys[0]);
+		few.push_back(mp.begin()->first);
+		map_batch_lookups(mp, few);
+		map_batch_lookups(mp, ft::vector<int>());
+		map_batch_lookups(ft::map<int, int>(), few);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Frozen Snapshot");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 200; i++)
+			mp.insert(ft::make_pair(rand() % 1000, i));
+		frozen_int_map frozen = freeze_map(mp);
+		mp.clear();
+		std::cout << frozen.size() << ' ' << frozen.empty() << std::endl;
+		for (frozen_int_map::const_iterator it = frozen.begin(); it != frozen.end(); ++it)
+			std::cout << ' ' << it->first << '=' << it->second;
+		std::cout << std::endl;
+		frozen_int_map::const_reverse_iterator rit = frozen.rbegin();
+		for (int i = 0; i < 10 && rit != frozen.rend(); ++i, ++rit)
+			std::cout << ' ' << rit->first;
+		frozen_int_map::const_iterator last = frozen.end();
+		--last;
+		std::cout << ' ' << last->first << std::endl;
+		ft::vector<int> keys;
+		for (int i = 0; i < 40; i++)
+			keys.push_back(rand() % 1100 - 50);
+		keys.push_back(frozen.begin()->first);
+		keys.push_back(last->first);
+		print_frozen_lookups(frozen, keys);
+		std::cout << frozen.at(last->first);
+		try
+		{
+			frozen.at(-1);
+		}
+		catch (std::out_of_range&)
+		{
+			std::cout << " caught out_of_range";
+		}
+		std::cout << std::endl;
+		frozen_int_map empty = freeze_map(ft::map<int, int>());
+		std::cout << empty.size() << ' ' << empty.empty() << ' ' << (empty.begin() == empty.end()) << std::endl;
+		print_frozen_lookups(empty, keys);
+		frozen.swap(empty);
+		std::cout << frozen.size() << ' ' << empty.size() << std::endl;
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Tree Shape Stats");
+		ft::map<int, int> mp;
+		ft::vector<int> inserted;
+		print_map_stats(mp, inserted);
+		for (int i = 0; i < 500; i++)
+		{
+			inserted.push_back(rand() % 2000);
+			mp.insert(ft::make_pair(inserted.back(), i));
+		}
+		print_map_stats(mp, inserted);
+		ft::map<int, int> chain;
+		ft::vector<int> ascending;
+		for (int i = 0; i < 40; i++)
+		{
+			ascending.push_back(i);
+			chain.insert(ft::make_pair(i, i));
+		}
+		print_map_stats(chain, ascending);
+	}
+	// **************************************************
+	{
+		outputTitle("Vector/Map: Binary Snapshot");
+		ft::vector<int> vec;
+		for (int i = 0; i < 1000; i++)
+			vec.push_back(rand());
+		ft::map<int, std::string> mp;
+		for (int i = 0; i < 300; i++)
+		{
+			std::ostringstream name;
+			name << "entry " << i;
+			mp[rand() % 1000] = name.str();
+		}
+		ft::vector<int> vecCopy;
+		ft::map<int, std::string> mapCopy;
+		snapshot_copy(vec, vecCopy);
+		snapshot_copy(mp, mapCopy);
+		std::cout << vecCopy.size() << ' ' << (vecCopy == vec) << ' ' << mapCopy.size() << ' ' << (mapCopy == mp) << std::endl;
+		std::cout << vecCopy.front() << ' ' << vecCopy.back() << ' ' << mapCopy.begin()->second << ' ' << (--mapCopy.end())->first << std::endl;
+		ft::vector<int> empty;
+		vecCopy.push_back(1);
+		snapshot_copy(empty, vecCopy);
+		std::cout << vecCopy.size() << std::endl;
+		ft::vector<int> vecFromFile;
+		ft::map<int, std::string> mapFromFile;
+		snapshot_copy_file(vec, mp, vecFromFile, mapFromFile);
+		std::cout << (vecFromFile == vec) << ' ' << (mapFromFile == mp) << std::endl;
+		std::cout << snapshot_load_truncated(mp, mapCopy) << ' ' << mapCopy.size() << std::endl;
+		std::cout << snapshot_load_truncated(vec, vecCopy) << ' ' << vecCopy.size() << std::endl;
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Mapped From a File");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 300; i++)
+			mp.insert(ft::make_pair(rand() % 1000, i));
+		mapped_int_map table;
+		map_from_file(mp, table);
+		std::cout << table.size() << ' ' << table.empty() << std::endl;
+		long long sum = 0;
+		for (mapped_int_map::const_iterator it = table.begin(); it != table.end(); ++it)
+			sum += (*it).first * 7 + it->second;
+		mapped_int_map::const_iterator last = table.end();
+		--last;
+		std::cout << sum << ' ' << table.begin()->first << ' ' << last->first << '=' << last->second << std::endl;
+		ft::vector<int> keys;
+		for (int i = 0; i < 40; i++)
+			keys.push_back(rand() % 1100 - 50);
+		keys.push_back(last->first);
+		print_frozen_lookups(table, keys);
+		std::cout << table.at(last->first);
+		try
+		{
+			table.at(-1);
+		}
+		catch (std::out_of_range&)
+		{
+			std::cout << " caught out_of_range";
+		}
+		std::cout << std::endl;
+		mp.clear();
+		mp[5] = 50;
+		mp[-3] = 30;
+		map_from_fd(mp, table);
+		std::cout << table.size() << ' ' << table.begin()->first << ' ' << table.at(5) << std::endl;
+		map_from_fd(ft::map<int, int>(), table);
+		std::cout << table.size() << ' ' << table.empty() << ' ' << (table.begin() == table.end()) << std::endl;
+		print_frozen_lookups(table, keys);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Range Erase and Extract");
+		ft::map<int, int> mp;
+		for (int i = 0; i < 300; i++)
+			mp.insert(ft::make_pair(rand() % 1000, i));
+		mp.erase(mp.lower_bound(200), mp.lower_bound(400));
+		print_map(1, mp);
+		ft::map<int, int> cut;
+		cut[1] = 1;
+		map_extract_range(mp, 500, 700, cut);
+		print_map(2, mp);
+		print_map(3, cut);
+		mp.erase(mp.begin(), mp.lower_bound(100));
+		mp.erase(mp.lower_bound(900), mp.end());
+		mp.erase(mp.find(mp.begin()->first), mp.find(mp.begin()->first));
+		print_map(4, mp);
+		ft::map<int, int> none = map_extract_range(mp, 300, 300);
+		print_map(5, none);
+		for (ft::map<int, int>::iterator it = cut.begin(); it != cut.end(); ++it)
+			mp.insert(*it);
+		cut.erase(cut.begin(), cut.end());
+		print_map(6, mp);
+		print_map(7, cut);
+		mp.erase(mp.begin(), mp.end());
+		print_map(8, mp);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Set Algebra Into");
+		ft::map<int, int> a, b, out;
+		for (int i = 0; i < 60; i++)
+		{
+			a.insert(ft::make_pair(rand() % 100, i));
+			b.insert(ft::make_pair(rand() % 100, -i));
+		}
+		out[-1] = -1;
+		for (int op = 0; op < 3; op++)
+		{
+			map_algebra_into(a, b, op, false, out);
+			print_map(op + 1, out);
+		}
+		// the result may replace an input
+		ft::map<int, int> first(a);
+		map_algebra_into(first, b, 2, false, first);
+		print_map(4, first);
+		map_algebra_into(a, b, 0, true, a);
+		print_map(5, a);
+		print_map(6, b);
+	}
+	// **************************************************
+	{
+		outputTitle("Map: Node Handles and Merge");
+		ft::map<int, int> first, second, small;
+		for (int i = 0; i < 100; i++)
+		{
+			first.insert(ft::make_pair(rand() % 300, i));
+			second.insert(ft::make_pair(rand() % 300, -i));
+		}
+		for (int k = 0; k < 300; k += 7)
+			map_move_node(first, second, k);
+		std::cout << std::endl;
+		print_map(1, first);
+		print_map(2, second);
+		map_merge(first, second);
+		print_map(3, first);
+		print_map(4, second);
+		for (int i = 0; i < 5; i++)
+			small.insert(ft::make_pair(rand() % 400, 1000 + i));
+		map_merge(first, small);
+		print_map(5, first);
+		print_map(6, small);
+		map_merge(small, first);
+		print_map(7, first);
+		print_map(8, small);
+		map_merge(small, first);
+		print_map(9, small);
+	}
+	// **************************************************
 	{
 		outputTitle("Stack: Different Base Container");
 		ft::stack<int, ft::vector<int> > stack_ft_vec;
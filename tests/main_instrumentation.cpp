@@ -0,0 +1,138 @@
+#include <iostream>
+#include <cstdlib>
+#include "../map.hpp"
+#include "../vector.hpp"
+#include "../instrumentation.hpp"
+
+#if __cplusplus >= 201103L
+	#include <thread>
+	#include <vector>
+#endif
+
+// Checks the counts of ft::instrumentation on workloads whose events are
+// known exactly. Built with -D FT_INSTRUMENTATION=1 the counts must match;
+// built without, every count must stay 0. Exits 1 on any mismatch.
+
+typedef ft::instrumentation		counters;
+
+int		failures = 0;
+
+void	expect(const char* what, const ft::instrumentationSnapshot& events, ft::events::container where,
+			ft::events::kind kind, unsigned long long expected)
+{
+	if (!counters::enabled)
+		expected = 0;
+	unsigned long long got = events(where, kind);
+	std::cout << (got == expected ? "OK " : "KO ") << what << ": " << ft::events::containerName(where)
+		<< ' ' << ft::events::kindName(kind) << ' ' << got;
+	if (got != expected)
+	{
+		std::cout << ", expected " << expected;
+		++failures;
+	}
+	std::cout << std::endl;
+}
+
+// 100 push_backs from empty: buffers of 1, 2, 4, ... 128 elements, each
+// growth copying the elements of the buffer it leaves
+void	vectorGrowth()
+{
+	ft::instrumentationSnapshot before = counters::snapshot();
+	ft::vector<int> vec;
+	for (int i = 0; i < 100; i++)
+		vec.push_back(i);
+	ft::instrumentationSnapshot growth = counters::snapshot() - before;
+	expect("100 push_backs", growth, ft::events::VECTOR, ft::events::ALLOCATIONS, 8);
+	expect("100 push_backs", growth, ft::events::VECTOR, ft::events::REALLOCATIONS, 7);
+	expect("100 push_backs", growth, ft::events::VECTOR, ft::events::BYTES_COPIED, 127 * sizeof(int));
+
+	before = counters::snapshot();
+	long sum = 0;
+	for (ft::vector<int>::iterator it = vec.begin(); it != vec.end(); ++it)
+		sum += *it;
+	expect("walk of 100", counters::snapshot() - before, ft::events::VECTOR, ft::events::ITERATOR_STEPS, 100);
+	if (sum != 4950)
+		++failures;
+}
+
+// the tree is not balanced, so the insertion order fixes its shape:
+//        4
+//    2       6
+//  1   3   5   7
+// find compares the key with every node above the one it stops at
+void	treeLookups()
+{
+	const int keys[] = { 4, 2, 6, 1, 3, 5, 7 };
+	ft::instrumentationSnapshot before = counters::snapshot();
+	ft::map<int, int> mp;
+	for (int i = 0; i < 7; i++)
+		mp.insert(ft::make_pair(keys[i], i));
+	expect("7 inserts", counters::snapshot() - before, ft::events::TREE, ft::events::ALLOCATIONS, 7);
+
+	// depths 0 + 1 + 1 + 2 + 2 + 2 + 2
+	before = counters::snapshot();
+	for (int k = 1; k <= 7; k++)
+		if (mp.find(k) == mp.end())
+			++failures;
+	ft::instrumentationSnapshot hits = counters::snapshot() - before;
+	expect("find of every key", hits, ft::events::TREE, ft::events::LOOKUPS, 7);
+	expect("find of every key", hits, ft::events::TREE, ft::events::COMPARISONS, 10);
+	expect("find of every key", hits, ft::events::TREE, ft::events::NODES_VISITED, 17);
+
+	// 4, 6 and 7, then off the tree
+	before = counters::snapshot();
+	if (mp.find(8) != mp.end())
+		++failures;
+	ft::instrumentationSnapshot miss = counters::snapshot() - before;
+	expect("find of a missing key", miss, ft::events::TREE, ft::events::LOOKUPS, 1);
+	expect("find of a missing key", miss, ft::events::TREE, ft::events::COMPARISONS, 3);
+	expect("find of a missing key", miss, ft::events::TREE, ft::events::NODES_VISITED, 3);
+
+	before = counters::snapshot();
+	int count = 0;
+	for (ft::map<int, int>::iterator it = mp.begin(); it != mp.end(); ++it)
+		++count;
+	expect("walk of 7", counters::snapshot() - before, ft::events::TREE, ft::events::ITERATOR_STEPS, 7);
+	if (count != 7)
+		++failures;
+}
+
+#if __cplusplus >= 201103L
+// every thread counts into its own block: the totals must still hold the
+// events of threads that are gone
+void	threadTotals()
+{
+	ft::instrumentationSnapshot before = counters::snapshot();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+		threads.push_back(std::thread([]()
+		{
+			ft::vector<int> vec;
+			for (int i = 0; i < 100; i++)
+				vec.push_back(i);
+		}));
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	ft::vector<int> vec;
+	for (int i = 0; i < 100; i++)
+		vec.push_back(i);
+	ft::instrumentationSnapshot growth = counters::snapshot() - before;
+	expect("100 push_backs on 5 threads", growth, ft::events::VECTOR, ft::events::ALLOCATIONS, 5 * 8);
+	expect("100 push_backs on 5 threads", growth, ft::events::VECTOR, ft::events::BYTES_COPIED, 5 * 127 * sizeof(int));
+}
+#endif
+
+int main()
+{
+	vectorGrowth();
+	treeLookups();
+#if __cplusplus >= 201103L
+	threadTotals();
+#endif
+	if (failures)
+	{
+		std::cout << failures << " instrumentation checks failed" << std::endl;
+		return (1);
+	}
+	return (0);
+}
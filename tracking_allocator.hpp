@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace ft
+{
+	// the tag of tracking_allocators that were not given one
+	struct default_tracking_tag { };
+
+	// Memory counters of one tag, as returned by allocation_tracker::stats.
+	// histogram[i] counts the allocations of 2^i to 2^(i + 1) - 1 bytes.
+	struct tracking_stats
+	{
+		static const int	buckets = 48;
+
+		size_t	live_bytes;
+		size_t	peak_bytes;
+		size_t	allocations;
+		size_t	deallocations;
+		size_t	histogram[buckets];
+
+		tracking_stats()
+			: live_bytes(0), peak_bytes(0), allocations(0), deallocations(0)
+		{
+			for (int i = 0; i < buckets; i++)
+				histogram[i] = 0;
+		}
+
+		size_t live_allocations() const
+		{
+			return allocations - deallocations;
+		}
+	};
+
+	// The counters shared by every tracking_allocator<T, Tag> of one Tag,
+	// whatever its T: what a container allocates through rebinds counts once.
+	// Updates are atomic, so containers on several threads may share a tag.
+	template<typename Tag>
+	class allocation_tracker
+	{
+	public:
+		static tracking_stats stats()
+		{
+			tracking_stats copy;
+			counters& c = shared();
+			copy.live_bytes = __atomic_load_n(&c.live_bytes, __ATOMIC_RELAXED);
+			copy.peak_bytes = __atomic_load_n(&c.peak_bytes, __ATOMIC_RELAXED);
+			copy.allocations = __atomic_load_n(&c.allocations, __ATOMIC_RELAXED);
+			copy.deallocations = __atomic_load_n(&c.deallocations, __ATOMIC_RELAXED);
+			for (int i = 0; i < tracking_stats::buckets; i++)
+				copy.histogram[i] = __atomic_load_n(&c.histogram[i], __ATOMIC_RELAXED);
+			return copy;
+		}
+
+		// starts a new peak measurement from the bytes live now
+		static void reset_peak()
+		{
+			counters& c = shared();
+			__atomic_store_n(&c.peak_bytes, __atomic_load_n(&c.live_bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+		}
+
+		static void dump(FILE* out, const char* name)
+		{
+			tracking_stats s = stats();
+			std::fprintf(out, "%s: %lu bytes live in %lu allocations, peak %lu bytes, %lu allocations in total\n",
+				name, static_cast<unsigned long>(s.live_bytes), static_cast<unsigned long>(s.live_allocations()),
+				static_cast<unsigned long>(s.peak_bytes), static_cast<unsigned long>(s.allocations));
+			for (int i = 0; i < tracking_stats::buckets; i++)
+				if (s.histogram[i])
+					std::fprintf(out, "  %lu-%lu bytes: %lu\n", 1UL << i, (2UL << i) - 1,
+						static_cast<unsigned long>(s.histogram[i]));
+		}
+
+		// prints the counters to stderr when the program exits; the name
+		// is not copied and must outlive the program
+		static void dump_at_exit(const char* name)
+		{
+			if (!__atomic_exchange_n(&exitName(), name, __ATOMIC_RELAXED))
+				std::atexit(dumpToStderr);
+		}
+
+		static void recordAllocation(size_t bytes)
+		{
+			counters& c = shared();
+			size_t live = __atomic_add_fetch(&c.live_bytes, bytes, __ATOMIC_RELAXED);
+			size_t peak = __atomic_load_n(&c.peak_bytes, __ATOMIC_RELAXED);
+			while (peak < live && !__atomic_compare_exchange_n(&c.peak_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+			__atomic_add_fetch(&c.allocations, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&c.histogram[bucket(bytes)], 1, __ATOMIC_RELAXED);
+		}
+
+		static void recordDeallocation(size_t bytes)
+		{
+			counters& c = shared();
+			__atomic_sub_fetch(&c.live_bytes, bytes, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&c.deallocations, 1, __ATOMIC_RELAXED);
+		}
+
+	private:
+		struct counters
+		{
+			size_t	live_bytes;
+			size_t	peak_bytes;
+			size_t	allocations;
+			size_t	deallocations;
+			size_t	histogram[tracking_stats::buckets];
+		};
+
+		// zero-initialised before any constructor runs, so containers with
+		// static storage can allocate through it during start-up
+		static counters& shared()
+		{
+			static counters	c;
+
+			return c;
+		}
+
+		static const char*& exitName()
+		{
+			static const char*	name = NULL;
+
+			return name;
+		}
+
+		static void dumpToStderr()
+		{
+			dump(stderr, exitName());
+		}
+
+		static int bucket(size_t bytes)
+		{
+			int i = 0;
+			while (bytes > 1 && i < tracking_stats::buckets - 1)
+			{
+				bytes >>= 1;
+				++i;
+			}
+			return i;
+		}
+	};
+
+	// std::allocator that reports every allocation to allocation_tracker<Tag>.
+	// Give ft::map or ft::vector one with a tag of their own to see what
+	// they really hold, node overhead and slack capacity included;
+	// rebind keeps the tag.
+	template<typename T, typename Tag = default_tracking_tag>
+	class tracking_allocator
+	{
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef size_t			size_type;
+		typedef ptrdiff_t		difference_type;
+		typedef Tag				tag_type;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef tracking_allocator<U, Tag>	other;
+		};
+
+		tracking_allocator() throw() { }
+
+		tracking_allocator(const tracking_allocator&) throw() { }
+
+		template<typename U>
+		tracking_allocator(const tracking_allocator<U, Tag>&) throw() { }
+
+		pointer address(reference x) const { return &x; }
+		const_pointer address(const_reference x) const { return &x; }
+
+		pointer allocate(size_type n, const void* = 0)
+		{
+			if (n > max_size())
+				throw std::bad_alloc();
+			pointer p = static_cast<pointer>(::operator new(n * sizeof(T)));
+			allocation_tracker<Tag>::recordAllocation(n * sizeof(T));
+			return p;
+		}
+
+		void deallocate(pointer p, size_type n)
+		{
+			allocation_tracker<Tag>::recordDeallocation(n * sizeof(T));
+			::operator delete(p);
+		}
+
+		size_type max_size() const throw()
+		{
+			return std::numeric_limits<size_type>::max() / sizeof(T);
+		}
+
+		void construct(pointer p, const T& val)
+		{
+			new (static_cast<void*>(p)) T(val);
+		}
+
+		void destroy(pointer p)
+		{
+			p->~T();
+		}
+
+		static tracking_stats stats()
+		{
+			return allocation_tracker<Tag>::stats();
+		}
+	};
+
+	// stateless: any two allocators of a tag can free each other's memory
+	template<typename T, typename U, typename Tag>
+	bool operator==(const tracking_allocator<T, Tag>&, const tracking_allocator<U, Tag>&) throw()
+	{
+		return true;
+	}
+
+	template<typename T, typename U, typename Tag>
+	bool operator!=(const tracking_allocator<T, Tag>&, const tracking_allocator<U, Tag>&) throw()
+	{
+		return false;
+	}
+}
@@ -113,6 +113,9 @@ namespace ft
 		pair() 
 			: first(), second() { };
 
+		pair(const pair& pr)
+			: first(pr.first), second(pr.second) { };
+
 		template <class U, class V>
 		pair(const pair<U, V>& pr)
 			: first(pr.first), second(pr.second) { };
@@ -208,6 +211,54 @@ namespace ft
 	struct are_same<T, T>
 		: public true_type {};
 
+	template <typename T>
+	struct remove_const
+	{
+		typedef T type;
+	};
+
+	template <typename T>
+	struct remove_const<const T>
+	{
+		typedef T type;
+	};
+
+	// Holds a T for a container that derives from it. An empty T (a
+	// stateless comparator or allocator) becomes a base class and takes no
+	// room; anything else, function pointers and final classes included, is
+	// a plain member. Slot tells two holders of the same T apart
+	template<typename T, int Slot = 0, bool Compress = __is_empty(T) && !__is_final(T)>
+	class compressedStorage
+	{
+	public:
+		compressedStorage()
+			: value() { }
+
+		explicit compressedStorage(const T& value)
+			: value(value) { }
+
+		T& get() { return value; }
+		const T& get() const { return value; }
+
+	private:
+		T	value;
+	};
+
+	template<typename T, int Slot>
+	class compressedStorage<T, Slot, true>
+		: private T
+	{
+	public:
+		compressedStorage()
+			: T() { }
+
+		explicit compressedStorage(const T& value)
+			: T(value) { }
+
+		T& get() { return *this; }
+		const T& get() const { return *this; }
+	};
+
 	template<class InputIt1, class InputIt2>
 	bool equal(InputIt1 first1, InputIt1 last1, InputIt2 first2)
 	{
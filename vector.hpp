@@ -1,15 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <algorithm>
 #include "iterator.hpp"
 #include <exception>
 #include <limits>
 #include "utils.hpp"
-#include <iostream>
+#include "simd.hpp"
+#include "instrumentation.hpp"
 #include <stdexcept>
 
-#define VECTOR_COMMENTS 0
-
 namespace ft
 {
 	template<typename T, typename Allocator = std::allocator<T> >
@@ -32,7 +32,10 @@ namespace ft
 	protected:
 		pointer dataAllocation(size_t n)
 		{
-			return (n != 0 ? getAllocator().allocate(n) : pointer());
+			if (n == 0)
+				return pointer();
+			instrumentation::record(events::VECTOR, events::ALLOCATIONS);
+			return getAllocator().allocate(n);
 		}
 
 		void dataDeallocation(pointer ptr, size_t n)
@@ -52,8 +55,6 @@ namespace ft
 	public:
 		void swapData(vectorBaseData& x)
 		{
-			if (VECTOR_COMMENTS)
-				std::cout << "vectorBase swapData() called" << std::endl;
 			std::swap(this->vectorBaseVar.start, x.start);
 			std::swap(this->vectorBaseVar.finish, x.finish);
 			std::swap(this->vectorBaseVar.endOfStorage, x.endOfStorage);
@@ -63,8 +64,6 @@ namespace ft
 		vectorBase()
 			: vectorBaseVar()
 		{
-			if (VECTOR_COMMENTS)
-				std::cout << "vectorBase default constructor called on " << std::endl;
 		}
 
 		vectorBase(const Allocator& a) throw()
@@ -84,9 +83,7 @@ namespace ft
 		
 		~vectorBase() throw()
 		{
-			if (VECTOR_COMMENTS)
-				std::cout << "vectorBase destructor called on " << this << " with " << this->vectorBaseVar.start << " to " << this->vectorBaseVar.finish << std::endl;
-			dataDeallocation(vectorBaseVar.start, vectorBaseVar.finish - vectorBaseVar.start);
+			dataDeallocation(vectorBaseVar.start, vectorBaseVar.endOfStorage - vectorBaseVar.start);
 		}
 
 		Allocator getAllocator() const throw()
@@ -110,6 +107,10 @@ namespace ft
 
 	};
 
+	// binary snapshots (snapshot.hpp) read straight into the buffer
+	template<typename Vector>
+	struct vectorSnapshot;
+
 	template<typename T, typename Allocator = std::allocator<T> >
 	class vector: private vectorBase<T, Allocator>
 	{
@@ -147,6 +148,7 @@ namespace ft
 
 	private:
 		void destroyElements();
+		void recordGrowth() const;
 
 // CAPACITY //
 
@@ -179,6 +181,8 @@ namespace ft
 		const_reference operator[] (size_type idx) const throw();
 		reference at(size_type n);
 		const_reference at(size_type n) const;
+		pointer data() throw();
+		const_pointer data() const throw();
 
 
 // MODIFIERS //
@@ -201,11 +205,29 @@ namespace ft
 		size_t capacityCalc (difference_type distance);
 		void erase_handler(difference_type distance, iterator position);
 
+		// range helpers, dispatched on the iterator category
+		template<typename InputIterator>
+		void rangeInitialize(InputIterator first, InputIterator last, std::input_iterator_tag);
+		template<typename ForwardIterator>
+		void rangeInitialize(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag);
+		template<typename InputIterator>
+		void rangeAssign(InputIterator first, InputIterator last, std::input_iterator_tag);
+		template<typename ForwardIterator>
+		void rangeAssign(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag);
+		template<typename InputIterator>
+		void rangeInsert(iterator position, InputIterator first, InputIterator last, std::input_iterator_tag);
+		template<typename ForwardIterator>
+		void rangeInsert(iterator position, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag);
+
 
 // OBSERVERS //
 
 	public:
 		allocator_type get_allocator() const;
+
+	private:
+		template<typename Vector>
+		friend struct vectorSnapshot;
 	};
 
 ////////////////////////////////////////////////////
@@ -217,8 +239,6 @@ namespace ft
 	ft::vector< T, Allocator>::vector (const Allocator& alloc) throw()//reference pages 
 		: vectorBase<T, Allocator>(alloc, 0)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector default constructor called" << std::endl;
 	};
 
 	//2)
@@ -226,8 +246,6 @@ namespace ft
 	ft::vector< T, Allocator>::vector (size_type n, const value_type& val, const Allocator& alloc)
 		:vectorBase<T, Allocator>(alloc, n)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector fill constructor called" << std::endl;
 		std::uninitialized_fill(this->vectorBaseVar.start, this->vectorBaseVar.start + n, val);
 		this->vectorBaseVar.finish = this->vectorBaseVar.start + n;
 	};
@@ -236,12 +254,29 @@ namespace ft
 	template<typename T, typename Allocator>
 	template <typename InputIterator>
 	ft::vector< T, Allocator>::vector(InputIterator first, InputIterator last, const Allocator& alloc, typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type*)
-		: vectorBase<T, Allocator>(alloc, ft::distance(first, last))
+		: vectorBase<T, Allocator>(alloc)
+	{
+		rangeInitialize(first, last, ft::iterator_category(first));
+	}
+
+	// input iterators can only be walked once, so grow while reading
+	template<typename T, typename Allocator>
+	template<typename InputIterator>
+	void ft::vector< T, Allocator>::rangeInitialize(InputIterator first, InputIterator last, std::input_iterator_tag)
+	{
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	// forward iterators can be measured first and copied into exact-size storage
+	template<typename T, typename Allocator>
+	template<typename ForwardIterator>
+	void ft::vector< T, Allocator>::rangeInitialize(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
 	{
-		if(VECTOR_COMMENTS == 1)
-			std::cout << "Vector range constructor called" << std::endl;
-		std::uninitialized_copy(first, last, this->vectorBaseVar.start);
-		this->vectorBaseVar.finish += ft::distance(first, last); 
+		difference_type distance = ft::distance(first, last);
+		this->vectorBaseVar.start = this->dataAllocation(distance);
+		this->vectorBaseVar.finish = std::uninitialized_copy(first, last, this->vectorBaseVar.start);
+		this->vectorBaseVar.endOfStorage = this->vectorBaseVar.start + distance;
 	}
 
 	//4)
@@ -249,8 +284,6 @@ namespace ft
 	ft::vector< T, Allocator>::vector (const vector& x)
 		:vectorBase<T, Allocator>(x.getAllocator(), x.capacity())
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector copy constructor called from " << &x << " on " << this << std::endl;
 		std::uninitialized_copy(x.vectorBaseVar.start, x.vectorBaseVar.finish, this->vectorBaseVar.start);
 		this->vectorBaseVar.finish = this->vectorBaseVar.start + x.size();
 	};
@@ -258,16 +291,12 @@ namespace ft
 	template<typename T, typename Allocator>
 	ft::vector< T, Allocator>::~vector() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector destructor called on " << this << std::endl;
 		destroyElements();
 	};
 
 	template<typename T, typename Allocator>
 	typename ft::vector< T, Allocator>::vec_reference ft::vector< T, Allocator>::operator=(const vector& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector copy assignement operator called from " << &rhs << " on " << this << std::endl;
 		// create temporary copy, but not with copy constructor, as this would differ in the capacity of vector compared to original container
 		if (this == &rhs)
 			return *this;
@@ -283,16 +312,23 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::destroyElements()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector destroyElements() called" << std::endl;
 		for (T* elem = this->vectorBaseVar.start; elem != this->vectorBaseVar.finish; ++elem)
 		{
-			if (VECTOR_COMMENTS)
-				std::cout << elem << std::endl;
 			this->getAllocator().destroy(elem);
 		}
 	}
 
+	// instrumentation hook, called while the elements are still in the old
+	// buffer they are about to leave
+	template<typename T, typename Allocator>
+	inline void ft::vector< T, Allocator>::recordGrowth() const
+	{
+		if (empty())
+			return;
+		instrumentation::record(events::VECTOR, events::REALLOCATIONS);
+		instrumentation::record(events::VECTOR, events::BYTES_COPIED, size() * sizeof(T));
+	}
+
 ////////////////////////////////////////////////////
 //****************** ITERATORS ******************//
 //////////////////////////////////////////////////
@@ -300,64 +336,48 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::iterator ft::vector< T, Allocator>::begin() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector begin() called" << std::endl;
 		return (iterator(this->vectorBaseVar.start));
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_iterator ft::vector< T, Allocator>::begin() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const begin() called" << std::endl;
 		return (const_iterator(this->vectorBaseVar.start));
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reverse_iterator ft::vector< T, Allocator>::rbegin() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector rbegin() called" << std::endl;
 		return reverse_iterator(end());
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reverse_iterator ft::vector< T, Allocator>::rbegin() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const rbegin() called" << std::endl;
 		return const_reverse_iterator(end());
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::iterator ft::vector< T, Allocator>::end() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector end() called" << std::endl;
 		return (iterator(this->vectorBaseVar.finish));
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_iterator ft::vector< T, Allocator>::end() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const end() called" << std::endl;
 		return (const_iterator(this->vectorBaseVar.finish));
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reverse_iterator ft::vector< T, Allocator>::rend() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector rend() called" << std::endl;
 		return reverse_iterator(begin());
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reverse_iterator ft::vector< T, Allocator>::rend() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const rend() called" << std::endl;
 		return const_reverse_iterator(begin());
 	}
 
@@ -368,32 +388,24 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::size_type ft::vector< T, Allocator>::size() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector size() called" << std::endl;
 		return (this->vectorBaseVar.finish - this->vectorBaseVar.start);
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::size_type ft::vector< T, Allocator>::max_size() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector max_size() called" << std::endl;
 		return (getAllocator().max_size());
 	}
 
 	template<typename T, typename Allocator>
 	inline bool ft::vector< T, Allocator>::empty() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector empty() called" << std::endl;
 		return (this->vectorBaseVar.start == this->vectorBaseVar.finish);
 	}
 
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::resize (size_type n, value_type val)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector resize() called" << std::endl;
 		if (n < size())
 		{
 			for (; n < size(); )
@@ -404,12 +416,13 @@ namespace ft
 			this->insert(end(), n - size(), val);
 		else
 		{
-			vectorBase<T, Allocator> temp(capacity()*2);
+			vectorBase<T, Allocator> temp(std::max(n, capacity()*2));
 			temp.vectorBaseVar.finish = temp.vectorBaseVar.start;
 			std::uninitialized_copy(this->vectorBaseVar.start, this->vectorBaseVar.finish, temp.vectorBaseVar.start);
 			temp.vectorBaseVar.finish += this->end() - this->begin();
 			std::uninitialized_fill_n(temp.vectorBaseVar.finish, n - size(), val);
 			temp.vectorBaseVar.finish += n - size();
+			this->recordGrowth();
 			this->destroyElements();
 			temp.swapData(this->vectorBaseVar);
 		}
@@ -418,16 +431,12 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::size_type ft::vector< T, Allocator>::capacity() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector capacity() called" << std::endl;
 		return (this->vectorBaseVar.endOfStorage - this->vectorBaseVar.start);
 	}
 
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::reserve(size_type n)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector reserve() called" << std::endl;
 		if (n > max_size())
 			throw std::runtime_error("vector::reserve");
 		if (capacity() < n)
@@ -436,6 +445,7 @@ namespace ft
 			temp.vectorBaseVar.finish = temp.vectorBaseVar.start;
 			std::uninitialized_copy(this->vectorBaseVar.start, this->vectorBaseVar.finish, temp.vectorBaseVar.start); // copy the elements of rhs into a temporary 
 			temp.vectorBaseVar.finish += this->size();
+			this->recordGrowth();
 			this->destroyElements();
 			temp.swapData(this->vectorBaseVar);
 		}
@@ -448,56 +458,42 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reference ft::vector< T, Allocator>::front() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector front() called" << std::endl;
 		return *begin();
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reference ft::vector< T, Allocator>::front() const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const front() called" << std::endl;
 		return *begin();
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reference ft::vector< T, Allocator>::back() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector back() called" << std::endl;
 		return *(end() - 1);
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reference ft::vector< T, Allocator>::back() const throw() 
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const back() called" << std::endl;
 		return *(end() - 1);
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reference ft::vector< T, Allocator>::operator[] (size_type idx) throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator[] overload called" << std::endl;
 		return *(this->vectorBaseVar.start + idx);
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reference ft::vector< T, Allocator>::operator[] (size_type idx) const throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const operator[] overload called" << std::endl;
 		return *(this->vectorBaseVar.start + idx);
 	}
 
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::reference ft::vector< T, Allocator>::at(size_type n)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector at() called" << std::endl;
 		if(n < 0 || n >= this->size())
 			throw std::out_of_range("vector::at out of range");
 		return (*this)[n];
@@ -506,13 +502,23 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline typename ft::vector< T, Allocator>::const_reference ft::vector< T, Allocator>::at(size_type n) const
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector const at() called" << std::endl;
 		if(n < 0 || n >= this->size())
 			throw std::out_of_range("vector::const_reference at out of range");
 		return (*this)[n];
 	}
 
+	template<typename T, typename Allocator>
+	inline typename ft::vector< T, Allocator>::pointer ft::vector< T, Allocator>::data() throw()
+	{
+		return this->vectorBaseVar.start;
+	}
+
+	template<typename T, typename Allocator>
+	inline typename ft::vector< T, Allocator>::const_pointer ft::vector< T, Allocator>::data() const throw()
+	{
+		return this->vectorBaseVar.start;
+	}
+
 ////////////////////////////////////////////////////
 //******************* MODIFIERS *****************//
 //////////////////////////////////////////////////
@@ -522,8 +528,29 @@ namespace ft
 	template<typename InputIterator>
 	void ft::vector< T, Allocator>::assign (InputIterator first, InputIterator last, typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type*)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector assign() range called" << std::endl;
+		rangeAssign(first, last, ft::iterator_category(first));
+	}
+
+	template<typename T, typename Allocator>
+	template<typename InputIterator>
+	void ft::vector< T, Allocator>::rangeAssign(InputIterator first, InputIterator last, std::input_iterator_tag)
+	{
+		pointer current = this->vectorBaseVar.start;
+		for (; first != last && current != this->vectorBaseVar.finish; ++first, ++current)
+			*current = *first;
+		if (first == last)
+			erase(iterator(current), end());
+		else
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+	}
+
+	template<typename T, typename Allocator>
+	template<typename ForwardIterator>
+	void ft::vector< T, Allocator>::rangeAssign(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+	{
 		difference_type distance = ft::distance(first, last);
 		if(distance > (difference_type)capacity())
 		{
@@ -547,8 +574,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::assign (size_type n, const value_type& val)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector assign() fill called" << std::endl;
 		if(n > capacity())
 		{
 			vectorBase<T, Allocator> temp(n);
@@ -571,8 +596,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	typename ft::vector< T, Allocator>::iterator ft::vector< T, Allocator>::insert (iterator position, const value_type& val)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector single element insert function called" << std::endl;
 
 		if (position == end())
 		{
@@ -599,6 +622,7 @@ namespace ft
 				++temp.vectorBaseVar.finish;
 				std::uninitialized_copy(this->vectorBaseVar.start + (position - this->begin()), this->vectorBaseVar.finish, temp.vectorBaseVar.finish);
 				temp.vectorBaseVar.finish += this->end() - position;
+				this->recordGrowth();
 				this->destroyElements();
 				temp.swapData(this->vectorBaseVar);
 				position = this->begin() + (&(*position) - temp.vectorBaseVar.start);
@@ -611,8 +635,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::insert (iterator position, size_type n, const value_type& val)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector fill insert function called" << std::endl;
 
 		if (position == end())
 		{
@@ -632,6 +654,7 @@ namespace ft
 				temp.vectorBaseVar.finish += n;
 				std::uninitialized_copy(this->vectorBaseVar.start + (position - this->begin()), this->vectorBaseVar.finish, temp.vectorBaseVar.finish);
 				temp.vectorBaseVar.finish += this->end() - position;
+				this->recordGrowth();
 				this->destroyElements();
 				temp.swapData(this->vectorBaseVar);
 			}
@@ -657,6 +680,7 @@ namespace ft
 				temp.vectorBaseVar.finish += n;
 				std::uninitialized_copy(this->vectorBaseVar.start + (position - this->begin()), this->vectorBaseVar.finish, temp.vectorBaseVar.finish);
 				temp.vectorBaseVar.finish += this->end() - position;
+				this->recordGrowth();
 				this->destroyElements();
 				temp.swapData(this->vectorBaseVar);
 			}
@@ -668,9 +692,30 @@ namespace ft
 	template<typename InputIterator>
 	void ft::vector< T, Allocator>::insert (iterator position, InputIterator first, InputIterator last, typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type*)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector fill insert function called" << std::endl;
+		rangeInsert(position, first, last, ft::iterator_category(first));
+	}
 
+	template<typename T, typename Allocator>
+	template<typename InputIterator>
+	void ft::vector< T, Allocator>::rangeInsert(iterator position, InputIterator first, InputIterator last, std::input_iterator_tag)
+	{
+		if (position == end())
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+		else if (first != last)
+		{
+			// the final size is unknown until the range is consumed, so buffer it once
+			vector temp(first, last, this->getAllocator());
+			insert(position, temp.begin(), temp.end());
+		}
+	}
+
+	template<typename T, typename Allocator>
+	template<typename ForwardIterator>
+	void ft::vector< T, Allocator>::rangeInsert(iterator position, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+	{
 		difference_type distance = ft::distance(first, last);
 		if (position == end())
 		{
@@ -690,6 +735,7 @@ namespace ft
 				temp.vectorBaseVar.finish += distance;
 				std::uninitialized_copy(this->vectorBaseVar.start + (position - this->begin()), this->vectorBaseVar.finish, temp.vectorBaseVar.finish);
 				temp.vectorBaseVar.finish += this->end() - position;
+				this->recordGrowth();
 				this->destroyElements();
 				temp.swapData(this->vectorBaseVar);
 			}
@@ -699,10 +745,24 @@ namespace ft
 		{
 			if (size() + distance <= capacity())
 			{
-				std::uninitialized_copy(this->vectorBaseVar.finish, this->vectorBaseVar.finish + distance, this->vectorBaseVar.finish - distance);
-				this->vectorBaseVar.finish += distance;
-				std::copy_backward(&(*position), this->vectorBaseVar.finish - 2 * distance, this->vectorBaseVar.finish - distance);
-				std::copy(first, last, position);
+				pointer oldFinish = this->vectorBaseVar.finish;
+				difference_type elemsAfter = end() - position;
+				if (elemsAfter > distance)
+				{
+					std::uninitialized_copy(oldFinish - distance, oldFinish, oldFinish);
+					this->vectorBaseVar.finish += distance;
+					std::copy_backward(&(*position), oldFinish - distance, oldFinish);
+					std::copy(first, last, position);
+				}
+				else
+				{
+					ForwardIterator mid = first;
+					for (difference_type i = 0; i < elemsAfter; ++i)
+						++mid;
+					this->vectorBaseVar.finish = std::uninitialized_copy(mid, last, oldFinish);
+					this->vectorBaseVar.finish = std::uninitialized_copy(&(*position), oldFinish, this->vectorBaseVar.finish);
+					std::copy(first, mid, position);
+				}
 			}
 			else
 			{
@@ -715,6 +775,7 @@ namespace ft
 				temp.vectorBaseVar.finish += distance;
 				std::uninitialized_copy(this->vectorBaseVar.start + (position - this->begin()), this->vectorBaseVar.finish, temp.vectorBaseVar.finish);
 				temp.vectorBaseVar.finish += this->end() - position;
+				this->recordGrowth();
 				this->destroyElements();
 				temp.swapData(this->vectorBaseVar);
 			}
@@ -743,8 +804,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	typename ft::vector< T, Allocator>::iterator ft::vector< T, Allocator>::erase (iterator position)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector erase() single element called" << std::endl;
 		erase_handler(1, position);
 		return position;
 	}
@@ -752,8 +811,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	typename ft::vector< T, Allocator>::iterator ft::vector< T, Allocator>::erase (iterator first, iterator last)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector erase() range called" << std::endl;
 		difference_type distance = ft::distance(first, last);
 		erase_handler(distance, first);
 		return (iterator(first));
@@ -771,10 +828,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::push_back(const T& x)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector push_back() called" << std::endl;
-		if (VECTOR_COMMENTS == 1)
-			std::cout << "Vector push_back() called" << std::endl;
 		if (this->vectorBaseVar.finish == this->vectorBaseVar.endOfStorage)
 		{
 			vectorBase<T, Allocator> temp(this->size() ? 2 * this->size() : 1);
@@ -783,6 +836,7 @@ namespace ft
 			temp.vectorBaseVar.finish += this->size();
 			this->getAllocator().construct(temp.vectorBaseVar.finish, x);
 			++temp.vectorBaseVar.finish;
+			this->recordGrowth();
 			this->destroyElements();
 			temp.swapData(this->vectorBaseVar);
 			return;
@@ -794,17 +848,13 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::pop_back() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector pop_back() called" << std::endl;
-		this->getAllocator().destroy(this->vectorBaseVar.finish);
 		--this->vectorBaseVar.finish;
+		this->getAllocator().destroy(this->vectorBaseVar.finish);
 	}
 
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::clear() throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector clear() called" << std::endl;
 		// vector<T>().swap(*this);
 		erase(begin(), end());
 	}
@@ -812,8 +862,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	void ft::vector< T, Allocator>::swap(vector& x) throw()
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector swap() member function called" << std::endl;
 		this->swapData(x.vectorBaseVar);
 	}
 
@@ -824,8 +872,6 @@ namespace ft
 	template<typename T, typename Allocator>
 	typename ft::vector< T, Allocator>::allocator_type ft::vector< T, Allocator>::get_allocator() const
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector get_allocator() member function called" << std::endl;
 		return this->getAllocator();
 	}
 
@@ -836,48 +882,36 @@ namespace ft
 	template<typename T, typename Allocator>
 	inline bool operator==(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator== overload called" << std::endl;
 		return (lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
 	}
 
 	template<typename T, typename Allocator>
 	inline bool operator<(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator< overload called" << std::endl;
 		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); 		
 	}
 
 	template<typename T, typename Allocator>
 	inline bool operator!=(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator!= overload called" << std::endl;
 		return !(lhs == rhs);
 	}
 
 	template<typename T, typename Allocator>
 	inline bool operator>(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator> overload called" << std::endl;
 		return rhs < lhs;
 	}
 
 	template<typename T, typename Allocator>
 	inline bool operator<=(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator<= overload called" << std::endl;
 		return !(rhs < lhs);
 	}
 
 	template<typename T, typename Allocator>
 	inline bool operator>=(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "Vector operator>= overload called" << std::endl;
 		return !(lhs < rhs);
 	}
 }
@@ -889,8 +923,6 @@ namespace std
 	template<class T, class Alloc>
 	inline void swap(ft::vector<T,Alloc>& a, ft::vector<T,Alloc>& b)
 	{
-		if (VECTOR_COMMENTS)
-			std::cout << "vector std::swap() specialization called on " << &a << " and " << &b << std::endl;
 		a.swap(b);
 	};
 }
\ No newline at end of file